@@ -1,7 +1,12 @@
 // PlayerInventory.cpp
 
 #include "Components/Inventory/Child/PlayerInventory.h"
+#include "Registry/ItemRegistry.h"
 #include "Net/UnrealNetwork.h"
+#include "TimerManager.h"
+#include "Registry/ContainerSubsystem.h"
+#include "Registry/ItemEffectSubsystem.h"
+#include "Data/PrimaryData/ItemInfo.h"
 
 UPlayerInventory::UPlayerInventory()
 {
@@ -9,6 +14,8 @@ UPlayerInventory::UPlayerInventory()
     DefaultInventorySize = 20;
     MaxInventorySize = 50;
     BaseWeightLimit = 100.0f;
+    TransferRadius = 300.0f;
+    WeightChangedInterval = 0.25f;
     
     bAutoStackItems = true;
     MinLevelForExpansion = 5;
@@ -40,11 +47,11 @@ void UPlayerInventory::InitializeInventory()
     if (GetOwnerRole() == ROLE_Authority)
     {
         // Set initial inventory size
-        MaxSlots = DefaultInventorySize;
+        ResizeContainer(DefaultInventorySize);
         MaxWeight = BaseWeightLimit;
         
-        // Initialize weight
-        UpdateCurrentWeight();
+        // Current weight is maintained by the slot index from here on
+        RequestWeightChangedBroadcast();
     }
 }
 
@@ -71,14 +78,11 @@ void UPlayerInventory::HandleInventoryExpansion(int32 NewSize)
     // Store old size for the event
     int32 OldSize = MaxSlots;
     
-    // Expand the inventory
-    MaxSlots = FMath::Min(NewSize, MaxInventorySize);
+    // Expand the inventory, new empty slots replicate as fast array adds
+    ResizeContainer(FMath::Min(NewSize, MaxInventorySize));
 
-    // Add new empty slots
     if (MaxSlots > OldSize)
     {
-        Items.SetNum(MaxSlots);
-        NotifyContainerUpdated();
         OnInventoryExpanded.Broadcast(OldSize, MaxSlots);
     }
 }
@@ -95,6 +99,24 @@ bool UPlayerInventory::ValidateItem(const FItemStructure& Item) const
            CheckLevelRequirement(Item);
 }
 
+int32 UPlayerInventory::GetAcceptableQuantity(const FItemStructure& Item) const
+{
+    if (!Super::ValidateItem(Item) || !IsItemTypeAllowed(Item) || !CheckLevelRequirement(Item))
+    {
+        return 0;
+    }
+
+    // Weightless items are only limited by slot space
+    const float UnitWeight = GetUnitWeight(Item);
+    if (UnitWeight <= 0.0f)
+    {
+        return Item.ItemQuantity;
+    }
+
+    const int32 FitsByWeight = FMath::FloorToInt32((MaxWeight - CurrentWeight) / UnitWeight + KINDA_SMALL_NUMBER);
+    return FMath::Clamp(FitsByWeight, 0, Item.ItemQuantity);
+}
+
 bool UPlayerInventory::CheckWeightLimit(const FItemStructure& Item) const
 {
     float newWeight = CurrentWeight + CalculateItemWeight(Item);
@@ -112,52 +134,76 @@ bool UPlayerInventory::IsItemTypeAllowed(const FItemStructure& Item) const
     return !RestrictedItemTypes.Contains(Item.ItemType);
 }
 
-float UPlayerInventory::CalculateItemWeight(const FItemStructure& Item) const
+float UPlayerInventory::GetUnitWeight(const FItemStructure& Item) const
 {
-    // Basic weight calculation based on weight class
-    float baseWeight;
-    switch (Item.WeightClass)
-    {
-        case E_WeightClass::Light:
-            baseWeight = 1.0f;
-            break;
-        case E_WeightClass::Medium:
-            baseWeight = 2.0f;
-            break;
-        case E_WeightClass::Heavy:
-            baseWeight = 5.0f;
-            break;
-        default:
-            baseWeight = 0.0f;
+    const UItemRegistry* Registry = GetItemRegistry();
+    if (!Registry)
+    {
+        return 0.0f;
     }
-    
-    return baseWeight * Item.ItemQuantity;
+    return Item.ItemHandle.IsValid() ? Registry->GetUnitWeightByHandle(Item.ItemHandle) : Registry->GetItemUnitWeight(Item.RegistryKey);
 }
 
-void UPlayerInventory::UpdateCurrentWeight()
+float UPlayerInventory::CalculateItemWeight(const FItemStructure& Item) const
 {
-    if (GetOwnerRole() != ROLE_Authority)
+    return GetUnitWeight(Item) * Item.ItemQuantity;
+}
+
+void UPlayerInventory::OnStackQuantityChanged(const FItemStructure& Item, int32 QuantityDelta)
+{
+    // The replicated weight is authoritative on clients, their Items are only a prediction
+    if (GetOwnerRole() != ROLE_Authority || QuantityDelta == 0)
     {
         return;
     }
 
-    float oldWeight = CurrentWeight;
-    float newWeight = 0.0f;
+    RunningWeight = FMath::Max(RunningWeight + static_cast<double>(GetUnitWeight(Item)) * QuantityDelta, 0.0);
 
-    for (const FItemStructure& Item : Items)
+    const float NewWeight = static_cast<float>(RunningWeight);
+    if (!FMath::IsNearlyEqual(NewWeight, CurrentWeight))
     {
-        if (!Item.IsEmpty())
-        {
-            newWeight += CalculateItemWeight(Item);
-        }
+        CurrentWeight = NewWeight;
+        RequestWeightChangedBroadcast();
     }
+}
 
-    CurrentWeight = newWeight;
+void UPlayerInventory::OnSlotIndexReset()
+{
+    if (GetOwnerRole() == ROLE_Authority)
+    {
+        RunningWeight = 0.0;
+        CurrentWeight = 0.0f;
+        RequestWeightChangedBroadcast();
+    }
+}
 
-    // Broadcast weight change if it changed
-    if (!FMath::IsNearlyEqual(oldWeight, CurrentWeight))
+void UPlayerInventory::RequestWeightChangedBroadcast()
+{
+    UWorld* World = GetWorld();
+    if (!World || WeightChangedInterval <= 0.0f)
     {
         OnWeightChanged.Broadcast(CurrentWeight, MaxWeight);
+        return;
+    }
+
+    // Leading broadcast, then at most one trailing broadcast per interval
+    FTimerManager& TimerManager = World->GetTimerManager();
+    if (TimerManager.IsTimerActive(WeightChangedTimerHandle))
+    {
+        bWeightChangedPending = true;
+        return;
+    }
+
+    OnWeightChanged.Broadcast(CurrentWeight, MaxWeight);
+    TimerManager.SetTimer(WeightChangedTimerHandle, this, &UPlayerInventory::HandleWeightChangedTimer, WeightChangedInterval, false);
+}
+
+void UPlayerInventory::HandleWeightChangedTimer()
+{
+    if (bWeightChangedPending)
+    {
+        bWeightChangedPending = false;
+        RequestWeightChangedBroadcast();
     }
 }
 
@@ -173,6 +219,86 @@ void UPlayerInventory::OnRep_CurrentWeight()
 
 bool UPlayerInventory::TransferToNearbyContainer()
 {
-    // TODO: Implement nearby container detection and transfer logic
-    return false;
+    UItemContainerBase* Target = FindNearbyContainer();
+    return Target && TransferItems(Target, FItemTransferRequest::MakeAll());
+}
+
+bool UPlayerInventory::ConsumeItem(int32 SlotIndex)
+{
+    if (GetOwnerRole() != ROLE_Authority)
+    {
+        // Queued ops go first so the server sees the slot the client sees
+        FlushPendingOps();
+        Server_ConsumeItem(SlotIndex);
+        return true;
+    }
+
+    return ConsumeItemInternal(SlotIndex);
+}
+
+void UPlayerInventory::Server_ConsumeItem_Implementation(int32 SlotIndex)
+{
+    ConsumeItemInternal(SlotIndex);
+}
+
+bool UPlayerInventory::ConsumeItemInternal(int32 SlotIndex)
+{
+    if (!Items.IsValidIndex(SlotIndex) || Items[SlotIndex].IsEmpty())
+    {
+        return false;
+    }
+
+    // Resolved by handle so this also works on servers running from the item database
+    UItemRegistry* Registry = GetItemRegistry();
+    TArray<FItemEffectSpec> ConsumeEffects;
+    if (!Registry || !Registry->GetConsumeEffects(Items[SlotIndex].ItemHandle, ConsumeEffects))
+    {
+        return false;
+    }
+
+    if (!RemoveItem(SlotIndex, 1))
+    {
+        return false;
+    }
+
+    if (UItemEffectSubsystem* Effects = UItemEffectSubsystem::Get(this))
+    {
+        Effects->ApplyEffects(GetOwner(), ConsumeEffects);
+    }
+    return true;
+}
+
+UItemContainerBase* UPlayerInventory::FindNearbyContainer() const
+{
+    AActor* Owner = GetOwner();
+    const UContainerSubsystem* Containers = UContainerSubsystem::Get(this);
+    if (!Owner || !Containers)
+    {
+        return nullptr;
+    }
+
+    FContainerQueryFilter Filter;
+    Filter.IgnoreActor = Owner;
+
+    TArray<UItemContainerBase*> Nearby;
+    Containers->FindContainersInRadius(Owner->GetActorLocation(), TransferRadius, Filter, Nearby);
+
+    // Same rule the server applies in CanConnectionAccess, by owning player so it also holds
+    // on clients and listen servers: containers owned by someone else are out of reach, and
+    // inventory-type containers are only reachable by their owner
+    const UPlayer* Player = Owner->GetNetOwningPlayer();
+    for (UItemContainerBase* Container : Nearby)
+    {
+        const AActor* ContainerOwner = Container->GetOwner();
+        const UPlayer* ContainerPlayer = ContainerOwner ? ContainerOwner->GetNetOwningPlayer() : nullptr;
+        const bool bAccessible = ContainerPlayer
+            ? ContainerPlayer == Player
+            : Container->GetContainerType() != E_ContainerType::Inventory;
+
+        if (bAccessible && !Container->IsA<UPlayerInventory>())
+        {
+            return Container;
+        }
+    }
+    return nullptr;
 }
\ No newline at end of file
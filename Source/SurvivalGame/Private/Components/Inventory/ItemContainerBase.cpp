@@ -1,9 +1,16 @@
 // ItemContainerBase.cpp
 
 #include "Components/Inventory/ItemContainerBase.h"
+#include "Core/SurvivalGameInstance.h"
+#include "Registry/ItemRegistry.h"
+#include "Registry/ContainerSubsystem.h"
+#include "Registry/ItemDecaySubsystem.h"
 #include "Net/UnrealNetwork.h"
+#include "Engine/NetConnection.h"
+#include "TimerManager.h"
 
 UItemContainerBase::UItemContainerBase()
+    : ReplicatedSlots(this)
 {
     // Disable tick by default for performance
     PrimaryComponentTick.bCanEverTick = false;
@@ -14,6 +21,7 @@ UItemContainerBase::UItemContainerBase()
     // Default configuration
     MaxSlots = 20;
     bAllowStacking = true;
+    MaxTransferDistance = 500.0f;
     ContainerType = E_ContainerType::Storage;
 }
 
@@ -21,8 +29,11 @@ void UItemContainerBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& O
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    // Replicate items array to all clients
-    DOREPLIFETIME(UItemContainerBase, Items);
+    // Replicate slot deltas to all clients
+    DOREPLIFETIME(UItemContainerBase, ReplicatedSlots);
+
+    // Op acknowledgements only matter to the client that sent them
+    DOREPLIFETIME_CONDITION(UItemContainerBase, OpAck, COND_OwnerOnly);
 }
 
 void UItemContainerBase::BeginPlay()
@@ -34,6 +45,64 @@ void UItemContainerBase::BeginPlay()
     
     // Initialize container slots
     InitializeContainer();
+
+    // Register for ID lookup, typed queries and nearby-container queries
+    if (UContainerSubsystem* Containers = UContainerSubsystem::Get(this))
+    {
+        Containers->RegisterContainer(this);
+    }
+
+    // Items stored before the registry numbered its catalog are re-indexed by handle once it has
+    UItemRegistry* Registry = GetItemRegistry();
+    if (Registry && !Registry->IsInitialized())
+    {
+        Registry->CallOrRegister_OnInitialized(FSimpleDelegate::CreateWeakLambda(this, [this]()
+        {
+            HandleItemRegistryInitialized();
+        }));
+    }
+}
+
+void UItemContainerBase::HandleItemRegistryInitialized()
+{
+    const UItemRegistry* Registry = GetItemRegistry();
+    if (!Registry || UnhandledSlotItemIds.Num() == 0)
+    {
+        return;
+    }
+
+    // The confirmed client state is patched too, predictions are rebuilt from it
+    for (TArray<FItemStructure>* SlotList : { &Items, &ServerItems })
+    {
+        for (FItemStructure& Item : *SlotList)
+        {
+            if (!Item.ItemHandle.IsValid() && !Item.IsEmpty())
+            {
+                Item.ItemHandle = Registry->FindItemHandle(Item.RegistryKey);
+            }
+        }
+    }
+
+    UnhandledSlotItemIds.Reset();
+    RebuildSlotIndex();
+}
+
+void UItemContainerBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UContainerSubsystem* Containers = UContainerSubsystem::Get(this))
+    {
+        Containers->UnregisterContainer(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UItemContainerBase::NotifyOwnerChanged()
+{
+    if (UContainerSubsystem* Containers = UContainerSubsystem::Get(this))
+    {
+        Containers->UpdateContainerOwner(this);
+    }
 }
 
 void UItemContainerBase::InitializeContainer()
@@ -41,11 +110,39 @@ void UItemContainerBase::InitializeContainer()
     if (GetOwnerRole() == ROLE_Authority)
     {
         // Initialize with empty slots
-        Items.SetNum(MaxSlots);
-        for (int32 i = 0; i < MaxSlots; ++i)
-        {
-            Items[i] = FItemStructure(); // Creates empty item structure
-        }
+        Items.Reset();
+        RebuildSlotIndex();
+        ReplicatedSlots.SetNumSlots(0);
+        ResizeContainer(MaxSlots);
+    }
+}
+
+void UItemContainerBase::ResizeContainer(int32 NewNumSlots)
+{
+    MaxSlots = FMath::Max(NewNumSlots, 0);
+
+    // Dropped slots leave the index before they are removed
+    const int32 OldNumSlots = Items.Num();
+    for (int32 i = MaxSlots; i < OldNumSlots; ++i)
+    {
+        UnindexSlot(i);
+    }
+
+    // New slots are default constructed, which is the empty item structure
+    Items.SetNum(MaxSlots);
+    FreeSlots.SetNum(MaxSlots, false);
+    SlotColumns.SetNum(MaxSlots);
+    ReplicatedSlots.SetNumSlots(MaxSlots);
+
+    for (int32 i = OldNumSlots; i < MaxSlots; ++i)
+    {
+        IndexSlot(i);
+        MarkSlotDirty(i);
+    }
+
+    if (GetOwnerRole() == ROLE_Authority && OldNumSlots != MaxSlots)
+    {
+        MarkContainerDirty();
     }
 }
 
@@ -75,36 +172,239 @@ bool UItemContainerBase::CanAddItem(const FItemStructure& Item, int32 TargetSlot
         return false;
     }
 
-    // Check for any available slot that can accept the item
-    for (int32 i = 0; i < Items.Num(); ++i)
+    // Any free slot accepts the item
+    if (NumFreeSlots > 0)
+    {
+        return true;
+    }
+
+    // Otherwise only a compatible stack with space left can take it
+    return bAllowStacking && FindStackWithSpace(Item) != INDEX_NONE;
+}
+
+bool UItemContainerBase::AddItem(const FItemStructure& Item, int32 TargetSlot)
+{
+    // Client-side request, the server rebuilds the item from the registry
+    if (GetOwnerRole() != ROLE_Authority)
+    {
+        const FItemContainerOp Op = FItemContainerOp::MakeAdd(Item, Item.ItemQuantity, TargetSlot);
+        return ApplyOps(MakeArrayView(&Op, 1));
+    }
+
+    BeginSlotTransaction();
+    const bool bSuccess = AddItemInternal(Item, TargetSlot);
+    EndSlotTransaction(bSuccess);
+    return bSuccess;
+}
+
+bool UItemContainerBase::AddItems(const TArray<FItemStructure>& Stacks, TArray<int32>& OutRemainders)
+{
+    OutRemainders.SetNumUninitialized(Stacks.Num());
+    for (int32 i = 0; i < Stacks.Num(); ++i)
     {
-        // Check empty slots
-        if (IsSlotEmpty(i))
+        OutRemainders[i] = FMath::Max(Stacks[i].ItemQuantity, 0);
+    }
+
+    // Same as ApplyOps, adds predicted on a container we do not own would never be confirmed
+    if (GetOwnerRole() != ROLE_Authority && !IsOwnedByLocalPlayer())
+    {
+        return false;
+    }
+
+    FNotificationBatchScope NotificationScope(this);
+    BeginSlotTransaction();
+
+    bool bAllAdded = true;
+    for (int32 i = 0; i < Stacks.Num(); ++i)
+    {
+        // Container rules (weight, type) cap each stack first, as in TransferItemsInternal
+        FItemStructure Accepted = Stacks[i];
+        Accepted.ItemQuantity = FMath::Min(Accepted.ItemQuantity, GetAcceptableQuantity(Accepted));
+        if (Accepted.ItemQuantity > 0)
         {
-            return true;
+            OutRemainders[i] -= Accepted.ItemQuantity - DistributeItemInternal(Accepted);
         }
+        bAllAdded &= OutRemainders[i] == 0;
+    }
 
-        // Check stackable slots
-        if (bAllowStacking && 
-            Items[i].RegistryKey == Item.RegistryKey &&
-            Items[i].ItemQuantity < Items[i].MaxStackSize)
+    // Partial adds are kept, the caller gets the remainders back
+    EndSlotTransaction(true);
+
+    // Clients send exactly what was predicted to fit
+    if (GetOwnerRole() != ROLE_Authority)
+    {
+        for (int32 i = 0; i < Stacks.Num(); ++i)
         {
-            return true;
+            const int32 Added = Stacks[i].ItemQuantity - OutRemainders[i];
+            if (Added > 0)
+            {
+                QueueOp(FItemContainerOp::MakeAdd(Stacks[i], Added, INDEX_NONE));
+            }
         }
     }
 
-    return false;
+    return bAllAdded;
 }
 
-bool UItemContainerBase::AddItem(const FItemStructure& Item, int32 TargetSlot)
+bool UItemContainerBase::RemoveItem(int32 SlotIndex, int32 Amount)
 {
     // Client-side request
     if (GetOwnerRole() != ROLE_Authority)
     {
-        Server_AddItem(Item, TargetSlot);
+        const FItemContainerOp Op = FItemContainerOp::MakeRemove(SlotIndex, Amount);
+        return ApplyOps(MakeArrayView(&Op, 1));
+    }
+
+    BeginSlotTransaction();
+    const bool bSuccess = RemoveItemInternal(SlotIndex, Amount);
+    EndSlotTransaction(bSuccess);
+    return bSuccess;
+}
+
+bool UItemContainerBase::MoveItem(int32 FromSlot, int32 ToSlot)
+{
+    const FItemContainerOp Op = FItemContainerOp::MakeMove(FromSlot, ToSlot);
+    return ApplyOps(MakeArrayView(&Op, 1));
+}
+
+bool UItemContainerBase::SplitStack(int32 FromSlot, int32 ToSlot, int32 Amount)
+{
+    const FItemContainerOp Op = FItemContainerOp::MakeSplit(FromSlot, ToSlot, Amount);
+    return ApplyOps(MakeArrayView(&Op, 1));
+}
+
+bool UItemContainerBase::MergeStacks(int32 FromSlot, int32 ToSlot, int32 Amount)
+{
+    const FItemContainerOp Op = FItemContainerOp::MakeMerge(FromSlot, ToSlot, Amount);
+    return ApplyOps(MakeArrayView(&Op, 1));
+}
+
+bool UItemContainerBase::Sort(E_SortMethod Method)
+{
+    const FItemContainerOp Op = FItemContainerOp::MakeSort(Method);
+
+    // Every moved slot is reported in one notification pass
+    FNotificationBatchScope NotificationScope(this);
+    return ApplyOps(MakeArrayView(&Op, 1));
+}
+
+bool UItemContainerBase::TransferItems(UItemContainerBase* Destination, const FItemTransferRequest& Request)
+{
+    if (!Destination || Destination == this)
+    {
+        return false;
+    }
+
+    if (GetOwnerRole() != ROLE_Authority)
+    {
+        // Server RPCs are dropped unless the calling container belongs to the local player
+        UItemContainerBase* Sender = nullptr;
+        if (IsOwnedByLocalPlayer())
+        {
+            Sender = this;
+        }
+        else if (Destination->IsOwnedByLocalPlayer())
+        {
+            Sender = Destination;
+        }
+
+        if (!Sender)
+        {
+            return false;
+        }
+
+        // Earlier requests have to reach the server before the transfer does
+        FlushPendingOps();
+        Destination->FlushPendingOps();
+        Sender->Server_TransferItems(this, Destination, Request);
         return true;
     }
 
+    return TransferItemsInternal(Destination, Request) > 0;
+}
+
+bool UItemContainerBase::ApplyOps(TConstArrayView<FItemContainerOp> Ops)
+{
+    // The server drops Server_ApplyOps from a connection that does not own the container and
+    // only the owner receives acks, anything predicted here would never be confirmed
+    const bool bIsAuthority = GetOwnerRole() == ROLE_Authority;
+    if (!bIsAuthority && !IsOwnedByLocalPlayer())
+    {
+        return false;
+    }
+
+    const bool bSuccess = ApplyOpsTransaction(Ops);
+
+    // Clients only send operations that could be predicted locally
+    if (bSuccess && !bIsAuthority)
+    {
+        for (const FItemContainerOp& Op : Ops)
+        {
+            QueueOp(Op);
+        }
+    }
+    return bSuccess;
+}
+
+bool UItemContainerBase::ApplyOpsTransaction(TConstArrayView<FItemContainerOp> Ops)
+{
+    BeginSlotTransaction();
+
+    bool bSuccess = true;
+    for (const FItemContainerOp& Op : Ops)
+    {
+        if (!ApplyOp(Op))
+        {
+            bSuccess = false;
+            break;
+        }
+    }
+
+    EndSlotTransaction(bSuccess);
+    return bSuccess;
+}
+
+bool UItemContainerBase::ApplyOp(const FItemContainerOp& Op)
+{
+    switch (Op.Type)
+    {
+        case E_ContainerOpType::Add:
+        {
+            const UItemRegistry* Registry = GetItemRegistry();
+            if (!Registry || Op.Quantity <= 0)
+            {
+                return false;
+            }
+
+            // Items are always built from the registry, never from client data.
+            // Untargeted adds may span several slots, targeted adds fill a single one
+            FItemStructure NewItem = Op.ItemHandle.IsValid()
+                ? Registry->CreateItemInstanceFromHandle(Op.ItemHandle, 1)
+                : Registry->CreateItemInstance(Op.RegistryKey, 1);
+            if (Op.TargetSlot >= 0 && Op.Quantity > (NewItem.bIsStackable ? NewItem.MaxStackSize : 1))
+            {
+                return false;
+            }
+            NewItem.ItemQuantity = Op.Quantity;
+            return AddItemInternal(NewItem, Op.TargetSlot);
+        }
+        case E_ContainerOpType::Remove:
+            return RemoveItemInternal(Op.SlotIndex, Op.Quantity);
+        case E_ContainerOpType::Move:
+            return MoveItemInternal(Op.SlotIndex, Op.TargetSlot);
+        case E_ContainerOpType::Split:
+            return SplitStackInternal(Op.SlotIndex, Op.TargetSlot, Op.Quantity);
+        case E_ContainerOpType::Merge:
+            return MergeStacksInternal(Op.SlotIndex, Op.TargetSlot, Op.Quantity);
+        case E_ContainerOpType::Sort:
+            return SortInternal(static_cast<E_SortMethod>(Op.Quantity));
+        default:
+            return false;
+    }
+}
+
+bool UItemContainerBase::AddItemInternal(const FItemStructure& Item, int32 TargetSlot)
+{
     if (!ValidateItem(Item))
     {
         return false;
@@ -120,7 +420,7 @@ bool UItemContainerBase::AddItem(const FItemStructure& Item, int32 TargetSlot)
 
         if (IsSlotEmpty(TargetSlot))
         {
-            UpdateSlot(TargetSlot, Item);
+            WriteSlot(TargetSlot, Item);
             return true;
         }
         else if (bAllowStacking && Items[TargetSlot].RegistryKey == Item.RegistryKey)
@@ -130,124 +430,1021 @@ bool UItemContainerBase::AddItem(const FItemStructure& Item, int32 TargetSlot)
             if (spaceInStack > 0)
             {
                 int32 amountToAdd = FMath::Min(spaceInStack, Item.ItemQuantity);
-                Items[TargetSlot].ItemQuantity += amountToAdd;
-                UpdateSlot(TargetSlot, Items[TargetSlot]);
+                WriteStackedQuantity(TargetSlot, Item, amountToAdd);
                 return true;
             }
         }
         return false;
     }
 
-    // Find suitable slot if no specific target
-    int32 emptySlot = GetFirstEmptySlot();
-    if (emptySlot != -1)
+    // Without a target the whole stack has to fit, spread over existing stacks and free slots
+    return DistributeItemInternal(Item) == 0;
+}
+
+int32 UItemContainerBase::DistributeItemInternal(const FItemStructure& Item)
+{
+    int32 Remaining = FMath::Max(Item.ItemQuantity, 0);
+
+    // Top up compatible partial stacks first, in slot order
+    if (bAllowStacking)
     {
-        UpdateSlot(emptySlot, Item);
-        return true;
+        for (int32 SlotIndex = FindStackWithSpace(Item); SlotIndex != INDEX_NONE && Remaining > 0;
+             SlotIndex = FindStackWithSpace(Item, SlotIndex + 1))
+        {
+            const int32 Added = FMath::Min(Remaining, Items[SlotIndex].GetRemainingStackSpace());
+            WriteStackedQuantity(SlotIndex, Item, Added);
+            Remaining -= Added;
+        }
+    }
+
+    // Overflow into free slots, one full stack at a time
+    const int32 StackLimit = Item.bIsStackable ? FMath::Max(Item.MaxStackSize, 1) : 1;
+    while (Remaining > 0 && NumFreeSlots > 0)
+    {
+        FItemStructure NewStack = Item;
+        NewStack.ItemQuantity = FMath::Min(Remaining, StackLimit);
+        WriteSlot(GetFirstEmptySlot(), NewStack);
+        Remaining -= NewStack.ItemQuantity;
     }
 
-    return false;
+    return Remaining;
 }
 
-bool UItemContainerBase::RemoveItem(int32 SlotIndex, int32 Amount)
+bool UItemContainerBase::RemoveItemInternal(int32 SlotIndex, int32 Amount)
 {
-    // Client-side request
-    if (GetOwnerRole() != ROLE_Authority)
+    if (!ValidateSlotIndex(SlotIndex) || IsSlotEmpty(SlotIndex) || Amount <= 0)
     {
-        Server_RemoveItem(SlotIndex, Amount);
-        return true;
+        return false;
     }
 
-    if (!ValidateSlotIndex(SlotIndex) || IsSlotEmpty(SlotIndex))
+    // Removing the whole stack empties the slot
+    WriteSlotQuantity(SlotIndex, Items[SlotIndex].ItemQuantity - Amount);
+    return true;
+}
+
+bool UItemContainerBase::MoveItemInternal(int32 FromSlot, int32 ToSlot)
+{
+    if (!ValidateSlotIndex(FromSlot) || !ValidateSlotIndex(ToSlot) || FromSlot == ToSlot || IsSlotEmpty(FromSlot))
     {
         return false;
     }
 
-    FItemStructure& SlotItem = Items[SlotIndex];
-    if (SlotItem.ItemQuantity <= Amount)
+    // Stack onto a compatible target, anything that does not fit stays behind
+    if (bAllowStacking && Items[FromSlot].CanStack(Items[ToSlot]))
     {
-        // Remove entire stack
-        UpdateSlot(SlotIndex, FItemStructure());
+        return MergeStacksInternal(FromSlot, ToSlot, 0);
     }
-    else
+
+    const FItemStructure Moved = Items[FromSlot];
+    WriteSlot(FromSlot, Items[ToSlot]);
+    WriteSlot(ToSlot, Moved);
+    return true;
+}
+
+bool UItemContainerBase::SplitStackInternal(int32 FromSlot, int32 ToSlot, int32 Amount)
+{
+    if (!ValidateSlotIndex(FromSlot) || !ValidateSlotIndex(ToSlot) || !IsSlotEmpty(ToSlot) || IsSlotEmpty(FromSlot))
+    {
+        return false;
+    }
+
+    const FItemStructure& Source = Items[FromSlot];
+    if (!Source.bIsStackable || Amount <= 0 || Amount >= Source.ItemQuantity)
     {
-        // Remove partial stack
-        SlotItem.ItemQuantity -= Amount;
-        UpdateSlot(SlotIndex, SlotItem);
+        return false;
     }
 
+    FItemStructure Split = Source;
+    Split.ItemQuantity = Amount;
+    WriteSlotQuantity(FromSlot, Source.ItemQuantity - Amount);
+    WriteSlot(ToSlot, Split);
     return true;
 }
 
-bool UItemContainerBase::HasItem(const FName& ItemID, int32& OutQuantity) const
+bool UItemContainerBase::MergeStacksInternal(int32 FromSlot, int32 ToSlot, int32 Amount)
 {
-    OutQuantity = 0;
-    for (const FItemStructure& Item : Items)
+    if (!bAllowStacking || !ValidateSlotIndex(FromSlot) || !ValidateSlotIndex(ToSlot) || FromSlot == ToSlot ||
+        IsSlotEmpty(FromSlot) || !Items[FromSlot].CanStack(Items[ToSlot]))
     {
-        if (Item.RegistryKey == ItemID)
-        {
-            OutQuantity += Item.ItemQuantity;
-        }
+        return false;
     }
-    return OutQuantity > 0;
+
+    const int32 Requested = Amount > 0 ? FMath::Min(Amount, Items[FromSlot].ItemQuantity) : Items[FromSlot].ItemQuantity;
+    const int32 Moved = FMath::Min(Requested, Items[ToSlot].GetRemainingStackSpace());
+    if (Moved <= 0)
+    {
+        return false;
+    }
+
+    WriteStackedQuantity(ToSlot, Items[FromSlot], Moved);
+    WriteSlotQuantity(FromSlot, Items[FromSlot].ItemQuantity - Moved);
+    return true;
 }
 
-int32 UItemContainerBase::GetFirstEmptySlot() const
+bool UItemContainerBase::SortInternal(E_SortMethod Method)
 {
-    for (int32 i = 0; i < Items.Num(); ++i)
+    if (Method == E_SortMethod::None || Method > E_SortMethod::Weight)
+    {
+        return false;
+    }
+
+    // Collect every stack in slot order, topping up earlier compatible stacks on the way
+    TArray<FItemStructure> Stacks;
+    Stacks.Reserve(Items.Num() - NumFreeSlots);
+    TMap<FName, TArray<int32>> OpenStacks;
+    const double DecayTime = UItemDecaySubsystem::GetDecayTime(this);
+
+    for (const FItemStructure& Item : Items)
     {
-        if (IsSlotEmpty(i))
+        if (Item.IsEmpty())
+        {
+            continue;
+        }
+
+        FItemStructure Remaining = Item;
+        if (bAllowStacking && Item.bIsStackable)
+        {
+            if (TArray<int32>* Open = OpenStacks.Find(Item.RegistryKey))
+            {
+                for (int32 i = 0; i < Open->Num() && Remaining.ItemQuantity > 0;)
+                {
+                    FItemStructure& Target = Stacks[(*Open)[i]];
+                    if (!Target.CanStack(Remaining))
+                    {
+                        ++i;
+                        continue;
+                    }
+
+                    const int32 Moved = FMath::Min(Remaining.ItemQuantity, Target.GetRemainingStackSpace());
+                    Target.MergeDecay(Remaining, Moved, DecayTime);
+                    Target.ItemQuantity += Moved;
+                    Remaining.ItemQuantity -= Moved;
+
+                    if (Target.GetRemainingStackSpace() <= 0)
+                    {
+                        Open->RemoveAt(i);
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+            }
+        }
+
+        if (Remaining.ItemQuantity > 0)
         {
-            return i;
+            const int32 StackIndexInList = Stacks.Add(Remaining);
+            if (bAllowStacking && Remaining.GetRemainingStackSpace() > 0)
+            {
+                OpenStacks.FindOrAdd(Remaining.RegistryKey).Add(StackIndexInList);
+            }
         }
     }
-    return -1;
-}
 
-bool UItemContainerBase::IsSlotEmpty(int32 SlotIndex) const
-{
-    return ValidateSlotIndex(SlotIndex) && Items[SlotIndex].IsEmpty();
-}
+    // Keys are computed once per stack so the comparator never touches the registry or FText
+    struct FSortKey
+    {
+        double Primary;
+        int32 NameRank;
+        int32 Quantity;
+        int32 StackIndex;
+    };
 
-void UItemContainerBase::UpdateSlot(int32 SlotIndex, const FItemStructure& Item)
-{
-    if (!ValidateSlotIndex(SlotIndex))
+    const UItemRegistry* Registry = GetItemRegistry();
+    TArray<FSortKey> Keys;
+    Keys.Reserve(Stacks.Num());
+
+    for (int32 i = 0; i < Stacks.Num(); ++i)
     {
-        return;
+        const FItemStructure& Stack = Stacks[i];
+        FSortKey& Key = Keys.AddDefaulted_GetRef();
+        Key.NameRank = Registry ? Registry->GetItemNameSortRank(Stack.RegistryKey) : 0;
+        Key.Quantity = Stack.ItemQuantity;
+        Key.StackIndex = i;
+
+        // Smaller primary keys sort first, so "highest first" orders are negated
+        switch (Method)
+        {
+            case E_SortMethod::Type:
+                Key.Primary = static_cast<double>(Stack.ItemType);
+                break;
+            case E_SortMethod::Rarity:
+                Key.Primary = -static_cast<double>(Stack.ItemRarity);
+                break;
+            case E_SortMethod::Value:
+                Key.Primary = Registry ? -static_cast<double>(Registry->GetItemBaseValue(Stack.RegistryKey)) * Stack.ItemQuantity : 0.0;
+                break;
+            case E_SortMethod::Weight:
+                Key.Primary = Registry ? -static_cast<double>(Registry->GetItemUnitWeight(Stack.RegistryKey)) * Stack.ItemQuantity : 0.0;
+                break;
+            default:
+                Key.Primary = 0.0;
+                break;
+        }
     }
 
-    Items[SlotIndex] = Item;
-    OnSlotUpdated.Broadcast(SlotIndex, Item);
-    NotifyContainerUpdated();
-}
+    // Ties fall back to name, then larger stacks, then previous position, which keeps the sort stable
+    Keys.Sort([](const FSortKey& A, const FSortKey& B)
+    {
+        if (A.Primary != B.Primary)
+        {
+            return A.Primary < B.Primary;
+        }
+        if (A.NameRank != B.NameRank)
+        {
+            return A.NameRank < B.NameRank;
+        }
+        if (A.Quantity != B.Quantity)
+        {
+            return A.Quantity > B.Quantity;
+        }
+        return A.StackIndex < B.StackIndex;
+    });
 
-void UItemContainerBase::NotifyContainerUpdated()
-{
-    OnContainerUpdated.Broadcast(Items);
+    // Write the result back, untouched slots are not journaled and never replicate
+    const FItemStructure EmptySlot;
+    for (int32 SlotIndex = 0; SlotIndex < Items.Num(); ++SlotIndex)
+    {
+        const FItemStructure& Sorted = Keys.IsValidIndex(SlotIndex) ? Stacks[Keys[SlotIndex].StackIndex] : EmptySlot;
+        if (!Items[SlotIndex].IsIdenticalInstance(Sorted))
+        {
+            WriteSlot(SlotIndex, Sorted);
+        }
+    }
+    return true;
 }
 
-void UItemContainerBase::OnRep_Items()
+int32 UItemContainerBase::TransferItemsInternal(UItemContainerBase* Destination, const FItemTransferRequest& Request)
 {
-    NotifyContainerUpdated();
-}
+    check(Destination && Destination != this);
 
-bool UItemContainerBase::ValidateSlotIndex(int32 SlotIndex) const
-{
-    return SlotIndex >= 0 && SlotIndex < MaxSlots;
-}
+    // Exact transfers fail early if the source cannot cover them
+    const bool bExactQuantity = Request.Mode == E_TransferMode::ItemQuantity;
+    if (bExactQuantity)
+    {
+        int32 OwnedQuantity = 0;
+        if (Request.Quantity <= 0 || !HasItem(Request.RegistryKey, OwnedQuantity) || OwnedQuantity < Request.Quantity)
+        {
+            return 0;
+        }
+    }
 
-bool UItemContainerBase::ValidateItem(const FItemStructure& Item) const
-{
+    FNotificationBatchScope SourceScope(this);
+    FNotificationBatchScope DestinationScope(Destination);
+    BeginSlotTransaction();
+    Destination->BeginSlotTransaction();
+
+    const int32 Wanted = bExactQuantity ? Request.Quantity : MAX_int32;
+    int32 Transferred = 0;
+
+    for (int32 SlotIndex = 0; SlotIndex < Items.Num() && Transferred < Wanted; ++SlotIndex)
+    {
+        if (IsSlotEmpty(SlotIndex) || !Request.Matches(Items[SlotIndex]))
+        {
+            continue;
+        }
+
+        // Destination rules cap the offer, then stacks and free slots take what they can
+        FItemStructure Offered = Items[SlotIndex];
+        Offered.ItemQuantity = FMath::Min(Offered.ItemQuantity, Wanted - Transferred);
+        Offered.ItemQuantity = FMath::Min(Offered.ItemQuantity, Destination->GetAcceptableQuantity(Offered));
+        if (Offered.ItemQuantity <= 0)
+        {
+            continue;
+        }
+
+        const int32 Moved = Offered.ItemQuantity - Destination->DistributeItemInternal(Offered);
+        if (Moved > 0)
+        {
+            WriteSlotQuantity(SlotIndex, Items[SlotIndex].ItemQuantity - Moved);
+            Transferred += Moved;
+        }
+    }
+
+    // Both sides commit or roll back together
+    const bool bCommit = bExactQuantity ? Transferred == Wanted : Transferred > 0;
+    Destination->EndSlotTransaction(bCommit);
+    EndSlotTransaction(bCommit);
+    return bCommit ? Transferred : 0;
+}
+
+bool UItemContainerBase::HasItem(const FName& ItemID, int32& OutQuantity) const
+{
+    const int32 SlotItemId = FindSlotItemId(ItemID);
+    OutQuantity = SlotItemId != INDEX_NONE ? ItemSlotKernels::CountQuantity(SlotColumns, SlotItemId) : 0;
+    return OutQuantity > 0;
+}
+
+int32 UItemContainerBase::GetFirstEmptySlot() const
+{
+    return NumFreeSlots > 0 ? FreeSlots.Find(true) : -1;
+}
+
+bool UItemContainerBase::IsSlotEmpty(int32 SlotIndex) const
+{
+    return FreeSlots.IsValidIndex(SlotIndex) && FreeSlots[SlotIndex];
+}
+
+void UItemContainerBase::UpdateSlot(int32 SlotIndex, const FItemStructure& Item)
+{
+    if (!ValidateSlotIndex(SlotIndex))
+    {
+        return;
+    }
+
+    SetSlotIndexed(SlotIndex, Item);
+    CommitSlot(SlotIndex);
+}
+
+void UItemContainerBase::SetSlotIndexed(int32 SlotIndex, const FItemStructure& Item)
+{
+    UnindexSlot(SlotIndex);
+    Items[SlotIndex] = Item;
+
+    // Items built outside the registry (data tables, Blueprints) get their handle on first store
+    FItemStructure& Stored = Items[SlotIndex];
+    if (!Stored.ItemHandle.IsValid() && !Stored.IsEmpty())
+    {
+        if (const UItemRegistry* Registry = GetItemRegistry())
+        {
+            Stored.ItemHandle = Registry->FindItemHandle(Stored.RegistryKey);
+        }
+    }
+
+    // The decay clock starts when an item is first stored on the server
+    if (Stored.CanDecay() && Stored.DecayTimestamp <= 0.0 && GetOwnerRole() == ROLE_Authority)
+    {
+        Stored.DecayTimestamp = FMath::Max(UItemDecaySubsystem::GetDecayTime(this), UE_DOUBLE_SMALL_NUMBER);
+    }
+
+    IndexSlot(SlotIndex);
+}
+
+void UItemContainerBase::IndexSlot(int32 SlotIndex)
+{
+    const FItemStructure& Item = Items[SlotIndex];
+    if (Item.IsEmpty())
+    {
+        FreeSlots[SlotIndex] = true;
+        ++NumFreeSlots;
+        SlotColumns.ClearSlot(SlotIndex);
+        return;
+    }
+
+    FreeSlots[SlotIndex] = false;
+    SlotColumns.SetSlot(SlotIndex, InternSlotItemId(Item), Item);
+    NextDecayTime = FMath::Min(NextDecayTime, Item.GetDecayExpiryTime());
+    OnStackQuantityChanged(Item, Item.ItemQuantity);
+}
+
+void UItemContainerBase::UnindexSlot(int32 SlotIndex)
+{
+    const FItemStructure& Item = Items[SlotIndex];
+    if (Item.IsEmpty())
+    {
+        if (FreeSlots[SlotIndex])
+        {
+            FreeSlots[SlotIndex] = false;
+            --NumFreeSlots;
+        }
+        return;
+    }
+
+    OnStackQuantityChanged(Item, -Item.ItemQuantity);
+    SlotColumns.ClearSlot(SlotIndex);
+}
+
+void UItemContainerBase::RebuildSlotIndex()
+{
+    FreeSlots.Init(false, Items.Num());
+    SlotColumns.SetNum(Items.Num());
+    NumFreeSlots = 0;
+    NextDecayTime = MAX_dbl;
+    OnSlotIndexReset();
+
+    for (int32 i = 0; i < Items.Num(); ++i)
+    {
+        IndexSlot(i);
+    }
+}
+
+int32 UItemContainerBase::GetSlotDurability(int32 SlotIndex) const
+{
+    return ValidateSlotIndex(SlotIndex) ? Items[SlotIndex].GetDurabilityAt(UItemDecaySubsystem::GetDecayTime(this)) : 0;
+}
+
+void UItemContainerBase::MaterializeDecay()
+{
+    if (GetOwnerRole() != ROLE_Authority)
+    {
+        return;
+    }
+
+    // Expired items are handled (and their events fired) by the normal path first
+    const double Now = UItemDecaySubsystem::GetDecayTime(this);
+    ProcessDecay(Now);
+
+    BeginSlotTransaction();
+    for (int32 SlotIndex = 0; SlotIndex < Items.Num(); ++SlotIndex)
+    {
+        if (Items[SlotIndex].IsDecaying())
+        {
+            FItemStructure Decayed = Items[SlotIndex];
+            if (Decayed.ApplyDecay(Now))
+            {
+                WriteSlot(SlotIndex, Decayed);
+            }
+        }
+    }
+    EndSlotTransaction(true);
+}
+
+void UItemContainerBase::ProcessDecay(double Now)
+{
+    if (Now < NextDecayTime || GetOwnerRole() != ROLE_Authority)
+    {
+        return;
+    }
+
+    TArray<int32, TInlineAllocator<8>> ExpiredSlots;
+    double NewNextDecayTime = MAX_dbl;
+
+    BeginSlotTransaction();
+    for (int32 SlotIndex = 0; SlotIndex < Items.Num(); ++SlotIndex)
+    {
+        const double ExpiryTime = Items[SlotIndex].GetDecayExpiryTime();
+        if (ExpiryTime > Now)
+        {
+            NewNextDecayTime = FMath::Min(NewNextDecayTime, ExpiryTime);
+            continue;
+        }
+
+        FItemStructure Decayed = Items[SlotIndex];
+        Decayed.ApplyDecay(Now);
+        WriteSlot(SlotIndex, Decayed);
+
+        // Rounding can leave a last point of durability, that slot simply expires a little later
+        if (Decayed.CurrentDurability > 0)
+        {
+            NewNextDecayTime = FMath::Min(NewNextDecayTime, Decayed.GetDecayExpiryTime());
+            continue;
+        }
+        ExpiredSlots.Add(SlotIndex);
+    }
+    EndSlotTransaction(true);
+
+    // The rescan is exact, unlike the running minimum kept by IndexSlot
+    NextDecayTime = NewNextDecayTime;
+
+    for (const int32 SlotIndex : ExpiredSlots)
+    {
+        const FItemStructure& Item = Items[SlotIndex];
+        if (Item.ItemState == E_ItemState::Spoiled)
+        {
+            OnItemSpoiled.Broadcast(SlotIndex, Item);
+        }
+        else
+        {
+            OnItemBroken.Broadcast(SlotIndex, Item);
+        }
+    }
+}
+
+int32 UItemContainerBase::FindStackWithSpace(const FItemStructure& Item, int32 StartIndex) const
+{
+    if (!Item.bIsStackable)
+    {
+        return INDEX_NONE;
+    }
+
+    // Same item, same state and a stack limit above the current quantity, i.e. CanStack with room
+    const int32 SlotItemId = FindSlotItemId(Item);
+    return SlotItemId != INDEX_NONE
+        ? ItemSlotKernels::FindFirstWithSpace(SlotColumns, SlotItemId, static_cast<uint8>(Item.ItemState), StartIndex)
+        : INDEX_NONE;
+}
+
+int32 UItemContainerBase::FindSlotItemId(const FItemStructure& Item) const
+{
+    if (Item.ItemHandle.IsValid())
+    {
+        return Item.ItemHandle.GetIndex();
+    }
+
+    const int32* SlotItemId = UnhandledSlotItemIds.Find(Item.RegistryKey);
+    return SlotItemId ? *SlotItemId : INDEX_NONE;
+}
+
+int32 UItemContainerBase::FindSlotItemId(FName RegistryKey) const
+{
+    const UItemRegistry* Registry = GetItemRegistry();
+    const FItemHandle Handle = Registry ? Registry->FindItemHandle(RegistryKey) : FItemHandle();
+    if (Handle.IsValid())
+    {
+        return Handle.GetIndex();
+    }
+
+    const int32* SlotItemId = UnhandledSlotItemIds.Find(RegistryKey);
+    return SlotItemId ? *SlotItemId : INDEX_NONE;
+}
+
+int32 UItemContainerBase::InternSlotItemId(const FItemStructure& Item)
+{
+    if (Item.ItemHandle.IsValid())
+    {
+        return Item.ItemHandle.GetIndex();
+    }
+
+    // Items the registry has not numbered (yet) get IDs above the handle range
+    if (const int32* SlotItemId = UnhandledSlotItemIds.Find(Item.RegistryKey))
+    {
+        return *SlotItemId;
+    }
+    return UnhandledSlotItemIds.Add(Item.RegistryKey, MAX_uint16 + 1 + UnhandledSlotItemIds.Num());
+}
+
+void UItemContainerBase::CommitSlot(int32 SlotIndex)
+{
+    const FItemStructure& Item = Items[SlotIndex];
+
+    // Clients never write the replicated list, their Items are a prediction
+    if (GetOwnerRole() == ROLE_Authority)
+    {
+        ReplicatedSlots.SetSlot(SlotIndex, Item);
+        MarkContainerDirty();
+    }
+    MarkSlotDirty(SlotIndex);
+}
+
+void UItemContainerBase::MarkContainerDirty()
+{
+    if (bDirtyInRegistry)
+    {
+        return;
+    }
+
+    if (UContainerSubsystem* Containers = UContainerSubsystem::Get(this))
+    {
+        Containers->MarkContainerDirty(this);
+    }
+    else
+    {
+        // Picked up by RegisterContainer
+        bDirtyInRegistry = true;
+    }
+}
+
+void UItemContainerBase::NotifyContainerUpdated()
+{
+    OnContainerUpdated.Broadcast(Items);
+}
+
+void UItemContainerBase::BeginNotificationBatch()
+{
+    ++NotificationBatchDepth;
+}
+
+void UItemContainerBase::EndNotificationBatch()
+{
+    if (!ensure(NotificationBatchDepth > 0))
+    {
+        return;
+    }
+
+    if (--NotificationBatchDepth == 0)
+    {
+        FlushSlotNotifications();
+    }
+}
+
+void UItemContainerBase::MarkSlotDirty(int32 SlotIndex)
+{
+    if (SlotIndex < 0)
+    {
+        return;
+    }
+
+    if (SlotIndex >= DirtySlots.Num())
+    {
+        DirtySlots.Add(false, SlotIndex + 1 - DirtySlots.Num());
+    }
+    DirtySlots[SlotIndex] = true;
+
+    // Outside a batch scope, everything written this frame is flushed together next tick
+    if (NotificationBatchDepth == 0 && !bNotificationFlushScheduled)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            bNotificationFlushScheduled = true;
+            World->GetTimerManager().SetTimerForNextTick(this, &UItemContainerBase::FlushSlotNotifications);
+        }
+    }
+}
+
+void UItemContainerBase::FlushSlotNotifications()
+{
+    bNotificationFlushScheduled = false;
+
+    // A batch scope that is still open flushes on its own when it ends
+    if (NotificationBatchDepth > 0)
+    {
+        return;
+    }
+
+    TArray<int32> ChangedSlots;
+    for (TConstSetBitIterator<> It(DirtySlots); It; ++It)
+    {
+        if (Items.IsValidIndex(It.GetIndex()))
+        {
+            ChangedSlots.Add(It.GetIndex());
+        }
+    }
+    DirtySlots.Init(false, Items.Num());
+
+    if (ChangedSlots.Num() == 0)
+    {
+        return;
+    }
+
+    for (const int32 SlotIndex : ChangedSlots)
+    {
+        OnSlotUpdated.Broadcast(SlotIndex, Items[SlotIndex]);
+    }
+    OnSlotsChanged.Broadcast(ChangedSlots);
+    NotifyContainerUpdated();
+}
+
+bool UItemContainerBase::IsOwnedByLocalPlayer() const
+{
+    const AActor* Owner = GetOwner();
+    return Owner && Owner->HasLocalNetOwner();
+}
+
+UItemRegistry* UItemContainerBase::GetItemRegistry() const
+{
+    if (USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this))
+    {
+        return GameInstance->GetItemRegistry();
+    }
+    return nullptr;
+}
+
+void UItemContainerBase::BeginSlotTransaction()
+{
+    check(!bInSlotTransaction);
+    bInSlotTransaction = true;
+    SlotJournal.Reset();
+}
+
+void UItemContainerBase::WriteSlot(int32 SlotIndex, const FItemStructure& Item)
+{
+    check(bInSlotTransaction && Items.IsValidIndex(SlotIndex));
+
+    // Keep the pre-transaction value the first time a slot is touched
+    if (!SlotJournal.Contains(SlotIndex))
+    {
+        SlotJournal.Add(SlotIndex, Items[SlotIndex]);
+    }
+    SetSlotIndexed(SlotIndex, Item);
+}
+
+void UItemContainerBase::WriteSlotQuantity(int32 SlotIndex, int32 NewQuantity)
+{
+    check(bInSlotTransaction && Items.IsValidIndex(SlotIndex));
+
+    if (NewQuantity <= 0)
+    {
+        WriteSlot(SlotIndex, FItemStructure());
+        return;
+    }
+
+    if (!SlotJournal.Contains(SlotIndex))
+    {
+        SlotJournal.Add(SlotIndex, Items[SlotIndex]);
+    }
+
+    // Quantity-only change, avoids copying the whole item
+    UnindexSlot(SlotIndex);
+    Items[SlotIndex].ItemQuantity = NewQuantity;
+    IndexSlot(SlotIndex);
+}
+
+void UItemContainerBase::WriteStackedQuantity(int32 SlotIndex, const FItemStructure& Source, int32 Amount)
+{
+    check(bInSlotTransaction && Items.IsValidIndex(SlotIndex));
+
+    if (Items[SlotIndex].DurabilityDecayRate <= 0.0f)
+    {
+        WriteSlotQuantity(SlotIndex, Items[SlotIndex].ItemQuantity + Amount);
+        return;
+    }
+
+    // Perishables carry a clock, keeping the target's would reset or spoil the added items
+    FItemStructure Stacked = Items[SlotIndex];
+    Stacked.MergeDecay(Source, Amount, UItemDecaySubsystem::GetDecayTime(this));
+    Stacked.ItemQuantity += Amount;
+    WriteSlot(SlotIndex, Stacked);
+}
+
+void UItemContainerBase::EndSlotTransaction(bool bCommit)
+{
+    check(bInSlotTransaction);
+    bInSlotTransaction = false;
+
+    if (!bCommit)
+    {
+        for (const TPair<int32, FItemStructure>& Entry : SlotJournal)
+        {
+            SetSlotIndexed(Entry.Key, Entry.Value);
+        }
+        SlotJournal.Reset();
+        return;
+    }
+
+    // Replayed predictions are diffed and broadcast by ReconcilePredictedState
+    if (bReplayingPredictions)
+    {
+        SlotJournal.Reset();
+        return;
+    }
+
+    // Only slots whose contents actually changed are replicated and broadcast
+    for (const TPair<int32, FItemStructure>& Entry : SlotJournal)
+    {
+        if (!Items[Entry.Key].IsIdenticalInstance(Entry.Value))
+        {
+            CommitSlot(Entry.Key);
+        }
+    }
+    SlotJournal.Reset();
+}
+
+void UItemContainerBase::QueueOp(const FItemContainerOp& Op)
+{
+    const bool bFirstPending = PendingOps.Num() == 0;
+    PendingOps.Add(Op);
+
+    // Everything requested during this frame goes out as one batch
+    if (bFirstPending)
+    {
+        if (UWorld* World = GetWorld())
+        {
+            World->GetTimerManager().SetTimerForNextTick(this, &UItemContainerBase::FlushPendingOps);
+        }
+    }
+}
+
+void UItemContainerBase::FlushPendingOps()
+{
+    // Ownership changed since the ops were queued. The server would drop the batch and acks
+    // go to the new owner, so roll every prediction back to the server state instead
+    if (PendingOps.Num() > 0 && !IsOwnedByLocalPlayer())
+    {
+        PendingOps.Reset();
+        PredictedBatches.Reset();
+        bPredictionsDiscarded = true;
+        RequestReconcile();
+        return;
+    }
+
+    int32 Sent = 0;
+    while (Sent < PendingOps.Num())
+    {
+        const int32 Count = FMath::Min(PendingOps.Num() - Sent, MaxOpsPerBatch);
+
+        FItemContainerOpBatch Batch;
+        Batch.Sequence = ++NextOpSequence;
+        Batch.Ops.Append(PendingOps.GetData() + Sent, Count);
+        Server_ApplyOps(Batch);
+
+        // Kept until acknowledged so it can be replayed over newer server state
+        PredictedBatches.Add({ Batch.Sequence, MoveTemp(Batch.Ops) });
+
+        Sent += Count;
+    }
+    PendingOps.Reset();
+}
+
+void UItemContainerBase::OnRep_OpAck()
+{
+    OnOpsAcknowledged.Broadcast(OpAck.Sequence, OpAck.bAccepted);
+    RequestReconcile();
+}
+
+void UItemContainerBase::RequestReconcile()
+{
+    if (bReconcilePending)
+    {
+        return;
+    }
+    bReconcilePending = true;
+
+    // Slot deltas and the op ack can arrive through separate callbacks, reconcile once after both
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().SetTimerForNextTick(this, &UItemContainerBase::ReconcilePredictedState);
+    }
+    else
+    {
+        ReconcilePredictedState();
+    }
+}
+
+void UItemContainerBase::ReconcilePredictedState()
+{
+    bReconcilePending = false;
+
+    // Batches the server has processed are now part of ServerItems
+    const bool bHadPredictions = PredictedBatches.Num() > 0 || PendingOps.Num() > 0 || bPredictionsDiscarded;
+    bPredictionsDiscarded = false;
+    const int32 AckedSequence = OpAck.Sequence;
+    PredictedBatches.RemoveAll([AckedSequence](const FPredictedOpBatch& Batch)
+    {
+        return Batch.Sequence <= AckedSequence;
+    });
+
+    FNotificationBatchScope NotificationScope(this);
+
+    // Without predictions Items already equals the previous snapshot, so only the
+    // slots that differed on arrival need to be copied and reported
+    if (!bHadPredictions && Items.Num() == ServerItems.Num())
+    {
+        for (TConstSetBitIterator<> It(ChangedServerSlots); It; ++It)
+        {
+            const int32 SlotIndex = It.GetIndex();
+            if (ServerItems.IsValidIndex(SlotIndex))
+            {
+                SetSlotIndexed(SlotIndex, ServerItems[SlotIndex]);
+                MarkSlotDirty(SlotIndex);
+            }
+        }
+        ChangedServerSlots.Init(false, ServerItems.Num());
+        return;
+    }
+    ChangedServerSlots.Init(false, ServerItems.Num());
+
+    TArray<FItemStructure> PreviousItems = MoveTemp(Items);
+    Items = ServerItems;
+    MaxSlots = Items.Num();
+    RebuildSlotIndex();
+
+    // Replay everything still in flight, a batch that no longer applies is dropped as a whole
+    bReplayingPredictions = true;
+    for (const FPredictedOpBatch& Batch : PredictedBatches)
+    {
+        ApplyOpsTransaction(Batch.Ops);
+    }
+    ApplyOpsTransaction(PendingOps);
+    bReplayingPredictions = false;
+
+    // The UI only sees the corrected result, flushed when the scope closes
+    for (int32 i = 0; i < Items.Num(); ++i)
+    {
+        if (!PreviousItems.IsValidIndex(i) || !Items[i].IsIdenticalInstance(PreviousItems[i]))
+        {
+            MarkSlotDirty(i);
+        }
+    }
+
+    // Dropped trailing slots have no dirty index to report
+    if (PreviousItems.Num() > Items.Num())
+    {
+        NotifyContainerUpdated();
+    }
+}
+
+void UItemContainerBase::HandleReplicatedSlotChanged(int32 SlotIndex, const FItemStructure& Item)
+{
+    if (SlotIndex < 0)
+    {
+        return;
+    }
+
+    // Slots can arrive in any order, grow the confirmed state as needed
+    const bool bNewSlot = SlotIndex >= ServerItems.Num();
+    if (bNewSlot)
+    {
+        ServerItems.SetNum(SlotIndex + 1);
+    }
+
+    // Diff against the previous snapshot, a re-sent but identical slot is not a change
+    if (!bNewSlot && ServerItems[SlotIndex].IsIdenticalInstance(Item))
+    {
+        return;
+    }
+
+    ServerItems[SlotIndex] = Item;
+
+    if (SlotIndex >= ChangedServerSlots.Num())
+    {
+        ChangedServerSlots.Add(false, SlotIndex + 1 - ChangedServerSlots.Num());
+    }
+    ChangedServerSlots[SlotIndex] = true;
+}
+
+void UItemContainerBase::HandleReplicatedSlotRemoved(int32 SlotIndex)
+{
+    if (!ServerItems.IsValidIndex(SlotIndex))
+    {
+        return;
+    }
+
+    // Removed entries are always trailing slots dropped by a shrink
+    ServerItems.SetNum(SlotIndex);
+    bServerSlotsRemoved = true;
+}
+
+void UItemContainerBase::HandleReplicatedSlotsReceived()
+{
+    // Nothing to reconcile if every received slot matched the snapshot
+    if (ChangedServerSlots.Contains(true) || bServerSlotsRemoved)
+    {
+        bServerSlotsRemoved = false;
+        RequestReconcile();
+    }
+}
+
+bool UItemContainerBase::ValidateSlotIndex(int32 SlotIndex) const
+{
+    return Items.IsValidIndex(SlotIndex);
+}
+
+bool UItemContainerBase::ValidateItem(const FItemStructure& Item) const
+{
     // Basic validation
     return !Item.IsEmpty() && Item.ItemQuantity > 0;
 }
 
-void UItemContainerBase::Server_AddItem_Implementation(const FItemStructure& Item, int32 TargetSlot)
+int32 UItemContainerBase::GetAcceptableQuantity(const FItemStructure& Item) const
 {
-    AddItem(Item, TargetSlot);
+    return ValidateItem(Item) ? Item.ItemQuantity : 0;
 }
 
-void UItemContainerBase::Server_RemoveItem_Implementation(int32 SlotIndex, int32 Amount)
+bool UItemContainerBase::IsWithinTransferRange(const UItemContainerBase* A, const UItemContainerBase* B)
 {
-    RemoveItem(SlotIndex, Amount);
+    const AActor* OwnerA = A ? A->GetOwner() : nullptr;
+    const AActor* OwnerB = B ? B->GetOwner() : nullptr;
+    if (!OwnerA || !OwnerB)
+    {
+        return false;
+    }
+
+    // Containers on the same actor (inventory and hotbar) are always in range
+    if (OwnerA == OwnerB)
+    {
+        return true;
+    }
+
+    const float Range = FMath::Min(A->MaxTransferDistance, B->MaxTransferDistance);
+    return FVector::DistSquared(OwnerA->GetActorLocation(), OwnerB->GetActorLocation()) <= FMath::Square(Range);
+}
+
+bool UItemContainerBase::CanConnectionAccess(const UItemContainerBase* Container, const UNetConnection* Connection)
+{
+    const AActor* Owner = Container ? Container->GetOwner() : nullptr;
+    if (!Owner || !Connection)
+    {
+        return false;
+    }
+
+    const UNetConnection* OwnerConnection = Owner->GetNetConnection();
+    if (OwnerConnection == Connection)
+    {
+        return true;
+    }
+    return !OwnerConnection && Container->GetContainerType() != E_ContainerType::Inventory;
+}
+
+void UItemContainerBase::Server_TransferItems_Implementation(UItemContainerBase* Source, UItemContainerBase* Destination, const FItemTransferRequest& Request)
+{
+    // The RPC has to come through one of the two containers, the other one has to be in
+    // reach, and the caller may not reach into containers of other players
+    const UNetConnection* Caller = GetOwner() ? GetOwner()->GetNetConnection() : nullptr;
+    if (!Source || !Destination || Source == Destination || (Source != this && Destination != this) ||
+        !CanConnectionAccess(Source, Caller) || !CanConnectionAccess(Destination, Caller) ||
+        !IsWithinTransferRange(Source, Destination))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: rejected transfer from %s to %s"), *GetNameSafe(this), *GetNameSafe(Source), *GetNameSafe(Destination));
+        return;
+    }
+
+    Source->TransferItemsInternal(Destination, Request);
+}
+
+void UItemContainerBase::Server_ApplyOps_Implementation(const FItemContainerOpBatch& Batch)
+{
+    bool bAccepted = false;
+    if (Batch.Ops.Num() <= MaxOpsPerBatch)
+    {
+        bAccepted = ApplyOps(Batch.Ops);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: rejected op batch %d with %d operations"), *GetNameSafe(this), Batch.Sequence, Batch.Ops.Num());
+    }
+
+    // A single acknowledgement per batch, replicated to the owning client
+    OpAck.Sequence = Batch.Sequence;
+    OpAck.bAccepted = bAccepted;
 }
\ No newline at end of file
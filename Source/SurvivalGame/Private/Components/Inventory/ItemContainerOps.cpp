@@ -0,0 +1,168 @@
+// ItemContainerOps.cpp
+
+#include "Components/Inventory/ItemContainerOps.h"
+#include "Data/Struct/ItemStructure.h"
+#include "Registry/ItemRegistry.h"
+
+FItemContainerOp FItemContainerOp::MakeAdd(const FItemStructure& Item, int32 InQuantity, int32 InTargetSlot)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Add;
+    Op.RegistryKey = Item.RegistryKey;
+    Op.ItemHandle = Item.ItemHandle;
+    Op.Quantity = InQuantity;
+    Op.TargetSlot = InTargetSlot;
+    return Op;
+}
+
+FItemContainerOp FItemContainerOp::MakeRemove(int32 InSlotIndex, int32 InQuantity)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Remove;
+    Op.SlotIndex = InSlotIndex;
+    Op.Quantity = InQuantity;
+    return Op;
+}
+
+FItemContainerOp FItemContainerOp::MakeMove(int32 InSlotIndex, int32 InTargetSlot)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Move;
+    Op.SlotIndex = InSlotIndex;
+    Op.TargetSlot = InTargetSlot;
+    return Op;
+}
+
+FItemContainerOp FItemContainerOp::MakeSplit(int32 InSlotIndex, int32 InTargetSlot, int32 InQuantity)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Split;
+    Op.SlotIndex = InSlotIndex;
+    Op.TargetSlot = InTargetSlot;
+    Op.Quantity = InQuantity;
+    return Op;
+}
+
+FItemContainerOp FItemContainerOp::MakeMerge(int32 InSlotIndex, int32 InTargetSlot, int32 InQuantity)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Merge;
+    Op.SlotIndex = InSlotIndex;
+    Op.TargetSlot = InTargetSlot;
+    Op.Quantity = InQuantity;
+    return Op;
+}
+
+FItemContainerOp FItemContainerOp::MakeSort(E_SortMethod InMethod)
+{
+    FItemContainerOp Op;
+    Op.Type = E_ContainerOpType::Sort;
+    Op.Quantity = static_cast<int32>(InMethod);
+    return Op;
+}
+
+FItemTransferRequest FItemTransferRequest::MakeAll()
+{
+    return FItemTransferRequest();
+}
+
+FItemTransferRequest FItemTransferRequest::MakeType(E_ItemType InItemType)
+{
+    FItemTransferRequest Request;
+    Request.Mode = E_TransferMode::MatchingType;
+    Request.ItemType = InItemType;
+    return Request;
+}
+
+FItemTransferRequest FItemTransferRequest::MakeCategory(E_ItemCategory InItemCategory)
+{
+    FItemTransferRequest Request;
+    Request.Mode = E_TransferMode::MatchingCategory;
+    Request.ItemCategory = InItemCategory;
+    return Request;
+}
+
+FItemTransferRequest FItemTransferRequest::MakeItem(FName InRegistryKey, int32 InQuantity)
+{
+    FItemTransferRequest Request;
+    Request.Mode = E_TransferMode::ItemQuantity;
+    Request.RegistryKey = InRegistryKey;
+    Request.Quantity = InQuantity;
+    return Request;
+}
+
+bool FItemTransferRequest::Matches(const FItemStructure& Item) const
+{
+    switch (Mode)
+    {
+        case E_TransferMode::All:
+            return true;
+        case E_TransferMode::MatchingType:
+            return Item.ItemType == ItemType;
+        case E_TransferMode::MatchingCategory:
+            return Item.ItemCategory == ItemCategory;
+        case E_TransferMode::ItemQuantity:
+            return Item.RegistryKey == RegistryKey;
+        default:
+            return false;
+    }
+}
+
+bool FItemContainerOp::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 WireType = static_cast<uint32>(Type);
+    Ar.SerializeInt(WireType, 8);
+
+    // Slots are offset by one so INDEX_NONE packs as zero
+    uint32 WireSlot = static_cast<uint32>(FMath::Max(SlotIndex, INDEX_NONE) + 1);
+    uint32 WireTarget = static_cast<uint32>(FMath::Max(TargetSlot, INDEX_NONE) + 1);
+    uint32 WireQuantity = static_cast<uint32>(FMath::Max(Quantity, 0));
+    Ar.SerializeIntPacked(WireSlot);
+    Ar.SerializeIntPacked(WireTarget);
+    Ar.SerializeIntPacked(WireQuantity);
+
+    const E_ContainerOpType WireOpType = static_cast<E_ContainerOpType>(WireType);
+    if (WireOpType == E_ContainerOpType::Add)
+    {
+        uint8 bHasHandle = Ar.IsSaving() && UItemRegistry::IsHandleVerified(Map, ItemHandle) ? 1 : 0;
+        Ar.SerializeBits(&bHasHandle, 1);
+        if (bHasHandle)
+        {
+            ItemHandle.NetSerialize(Ar, Map, bOutSuccess);
+        }
+        else
+        {
+            Ar << RegistryKey;
+        }
+
+        // The server resolves the key locally, so code reading RegistryKey keeps working
+        if (Ar.IsLoading())
+        {
+            const UItemRegistry* Registry = UItemRegistry::GetForPackageMap(Map);
+            if (bHasHandle)
+            {
+                RegistryKey = Registry ? Registry->GetItemKey(ItemHandle) : NAME_None;
+            }
+            else
+            {
+                ItemHandle = Registry ? Registry->FindItemHandle(RegistryKey) : FItemHandle();
+            }
+        }
+    }
+
+    if (Ar.IsLoading())
+    {
+        Type = WireOpType;
+        SlotIndex = static_cast<int32>(FMath::Min<uint32>(WireSlot, MAX_int32)) - 1;
+        TargetSlot = static_cast<int32>(FMath::Min<uint32>(WireTarget, MAX_int32)) - 1;
+        Quantity = static_cast<int32>(FMath::Min<uint32>(WireQuantity, MAX_int32));
+        if (WireOpType != E_ContainerOpType::Add)
+        {
+            RegistryKey = NAME_None;
+            ItemHandle.Reset();
+        }
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
@@ -0,0 +1,70 @@
+// ItemSlotArray.cpp
+
+#include "Components/Inventory/ItemSlotArray.h"
+#include "Components/Inventory/ItemContainerBase.h"
+
+void FItemSlotEntry::PreReplicatedRemove(const FItemSlotArray& InArraySerializer)
+{
+    if (UItemContainerBase* Container = InArraySerializer.GetOwner())
+    {
+        Container->HandleReplicatedSlotRemoved(SlotIndex);
+    }
+}
+
+void FItemSlotEntry::PostReplicatedAdd(const FItemSlotArray& InArraySerializer)
+{
+    if (UItemContainerBase* Container = InArraySerializer.GetOwner())
+    {
+        Container->HandleReplicatedSlotChanged(SlotIndex, Item);
+    }
+}
+
+void FItemSlotEntry::PostReplicatedChange(const FItemSlotArray& InArraySerializer)
+{
+    if (UItemContainerBase* Container = InArraySerializer.GetOwner())
+    {
+        Container->HandleReplicatedSlotChanged(SlotIndex, Item);
+    }
+}
+
+void FItemSlotArray::SetNumSlots(int32 NumSlots)
+{
+    NumSlots = FMath::Max(NumSlots, 0);
+    const int32 OldNum = Entries.Num();
+
+    if (NumSlots < OldNum)
+    {
+        // Trailing slots are dropped; clients receive a remove per entry
+        Entries.SetNum(NumSlots);
+        MarkArrayDirty();
+        return;
+    }
+
+    Entries.Reserve(NumSlots);
+    for (int32 i = OldNum; i < NumSlots; ++i)
+    {
+        FItemSlotEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.SlotIndex = i;
+        MarkItemDirty(Entry);
+    }
+}
+
+void FItemSlotArray::SetSlot(int32 SlotIndex, const FItemStructure& Item)
+{
+    if (!Entries.IsValidIndex(SlotIndex))
+    {
+        return;
+    }
+
+    FItemSlotEntry& Entry = Entries[SlotIndex];
+    Entry.Item = Item;
+    MarkItemDirty(Entry);
+}
+
+void FItemSlotArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+    if (Owner)
+    {
+        Owner->HandleReplicatedSlotsReceived();
+    }
+}
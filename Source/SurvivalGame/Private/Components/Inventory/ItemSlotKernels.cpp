@@ -0,0 +1,212 @@
+// ItemSlotKernels.cpp
+
+#include "Components/Inventory/ItemSlotKernels.h"
+#include "HAL/IConsoleManager.h"
+
+void FItemSlotColumns::SetNum(int32 NumSlots)
+{
+    // Zero-filled slots are empty (ItemId 0)
+    ItemIds.SetNumZeroed(NumSlots);
+    Quantities.SetNumZeroed(NumSlots);
+    StackLimits.SetNumZeroed(NumSlots);
+    Durabilities.SetNumZeroed(NumSlots);
+    States.SetNumZeroed(NumSlots);
+}
+
+void FItemSlotColumns::SetSlot(int32 SlotIndex, int32 ItemId, const FItemStructure& Item)
+{
+    ItemIds[SlotIndex] = ItemId;
+    Quantities[SlotIndex] = Item.ItemQuantity;
+    StackLimits[SlotIndex] = Item.bIsStackable ? Item.MaxStackSize : 0;
+    Durabilities[SlotIndex] = Item.bHasDurability ? Item.CurrentDurability : 0;
+    States[SlotIndex] = static_cast<uint8>(Item.ItemState);
+}
+
+void FItemSlotColumns::ClearSlot(int32 SlotIndex)
+{
+    ItemIds[SlotIndex] = 0;
+    Quantities[SlotIndex] = 0;
+    StackLimits[SlotIndex] = 0;
+    Durabilities[SlotIndex] = 0;
+    States[SlotIndex] = 0;
+}
+
+namespace ItemSlotKernels
+{
+    int32 CountQuantity(const int32* ItemIds, const int32* Quantities, int32 Num, int32 ItemId)
+    {
+        const VectorRegister4Int Key = VectorIntSet1(ItemId);
+        VectorRegister4Int Sum = VectorIntSet1(0);
+
+        int32 i = 0;
+        for (; i + 4 <= Num; i += 4)
+        {
+            // Matching lanes are all ones, so the AND keeps their quantity and zeroes the rest
+            const VectorRegister4Int Match = VectorIntCompareEQ(VectorIntLoad(ItemIds + i), Key);
+            Sum = VectorIntAdd(Sum, VectorIntAnd(Match, VectorIntLoad(Quantities + i)));
+        }
+
+        alignas(16) int32 Lanes[4];
+        VectorIntStoreAligned(Sum, Lanes);
+        int32 Total = Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+
+        for (; i < Num; ++i)
+        {
+            Total += ItemIds[i] == ItemId ? Quantities[i] : 0;
+        }
+        return Total;
+    }
+
+    int32 FindFirst(const int32* ItemIds, int32 Num, int32 ItemId, int32 StartIndex)
+    {
+        const VectorRegister4Int Key = VectorIntSet1(ItemId);
+
+        int32 i = FMath::Max(StartIndex, 0);
+        for (; i + 4 <= Num; i += 4)
+        {
+            const VectorRegister4Int Match = VectorIntCompareEQ(VectorIntLoad(ItemIds + i), Key);
+            const uint32 Lanes = static_cast<uint32>(VectorMaskBits(VectorCastIntToFloat(Match)));
+            if (Lanes != 0)
+            {
+                return i + static_cast<int32>(FMath::CountTrailingZeros(Lanes));
+            }
+        }
+
+        for (; i < Num; ++i)
+        {
+            if (ItemIds[i] == ItemId)
+            {
+                return i;
+            }
+        }
+        return INDEX_NONE;
+    }
+
+    int32 FindFirstWithSpace(const int32* ItemIds, const int32* Quantities, const int32* StackLimits,
+        const uint8* States, int32 Num, int32 ItemId, uint8 State, int32 StartIndex)
+    {
+        const VectorRegister4Int Key = VectorIntSet1(ItemId);
+
+        int32 i = FMath::Max(StartIndex, 0);
+        for (; i + 4 <= Num; i += 4)
+        {
+            const VectorRegister4Int SameItem = VectorIntCompareEQ(VectorIntLoad(ItemIds + i), Key);
+            const VectorRegister4Int HasSpace = VectorIntCompareGT(VectorIntLoad(StackLimits + i), VectorIntLoad(Quantities + i));
+            uint32 Lanes = static_cast<uint32>(VectorMaskBits(VectorCastIntToFloat(VectorIntAnd(SameItem, HasSpace))));
+
+            // States are bytes, candidates are rare enough to check them per lane
+            while (Lanes != 0)
+            {
+                const int32 SlotIndex = i + static_cast<int32>(FMath::CountTrailingZeros(Lanes));
+                if (States[SlotIndex] == State)
+                {
+                    return SlotIndex;
+                }
+                Lanes &= Lanes - 1;
+            }
+        }
+
+        for (; i < Num; ++i)
+        {
+            if (ItemIds[i] == ItemId && StackLimits[i] > Quantities[i] && States[i] == State)
+            {
+                return i;
+            }
+        }
+        return INDEX_NONE;
+    }
+}
+
+#if !UE_BUILD_SHIPPING
+namespace
+{
+    /** Times the structure-per-slot scans against the column kernels */
+    void RunSlotKernelBenchmark()
+    {
+        constexpr int32 Iterations = 2000;
+        constexpr int32 NumDistinctItems = 16;
+        const int32 SlotCounts[] = { 20, 200, 2000 };
+
+        for (const int32 NumSlots : SlotCounts)
+        {
+            TArray<FItemStructure> Items;
+            FItemSlotColumns Columns;
+            Items.SetNum(NumSlots);
+            Columns.SetNum(NumSlots);
+
+            // Three quarters of the slots hold one of a few items, the target sits near the end
+            for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+            {
+                if (SlotIndex % 4 == 3)
+                {
+                    continue;
+                }
+
+                FItemStructure& Item = Items[SlotIndex];
+                const int32 ItemId = 1 + (SlotIndex % NumDistinctItems);
+                Item.RegistryKey = FName(TEXT("BenchItem"), ItemId);
+                Item.bIsStackable = true;
+                Item.MaxStackSize = 20;
+                Item.ItemQuantity = 20;
+                Columns.SetSlot(SlotIndex, ItemId, Item);
+            }
+
+            const int32 TargetSlot = NumSlots - 2;
+            const int32 TargetId = NumDistinctItems + 1;
+            Items[TargetSlot].RegistryKey = FName(TEXT("BenchItem"), TargetId);
+            Items[TargetSlot].bIsStackable = true;
+            Items[TargetSlot].MaxStackSize = 20;
+            Items[TargetSlot].ItemQuantity = 5;
+            Columns.SetSlot(TargetSlot, TargetId, Items[TargetSlot]);
+            const FItemStructure Probe = Items[TargetSlot];
+
+            int64 Checksum = 0;
+
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                int32 Count = 0;
+                int32 FirstWithSpace = INDEX_NONE;
+                for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+                {
+                    const FItemStructure& Item = Items[SlotIndex];
+                    if (Item.RegistryKey == Probe.RegistryKey)
+                    {
+                        Count += Item.ItemQuantity;
+                    }
+                }
+                for (int32 SlotIndex = 0; SlotIndex < NumSlots && FirstWithSpace == INDEX_NONE; ++SlotIndex)
+                {
+                    if (Items[SlotIndex].CanStack(Probe) && Items[SlotIndex].GetRemainingStackSpace() > 0)
+                    {
+                        FirstWithSpace = SlotIndex;
+                    }
+                }
+                Checksum += Count + FirstWithSpace;
+            }
+            const double StructureSeconds = FPlatformTime::Seconds() - StartTime;
+
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+            {
+                const int32 Count = ItemSlotKernels::CountQuantity(Columns, TargetId);
+                const int32 FirstWithSpace = ItemSlotKernels::FindFirstWithSpace(Columns, TargetId, static_cast<uint8>(Probe.ItemState));
+                Checksum -= Count + FirstWithSpace;
+            }
+            const double ColumnSeconds = FPlatformTime::Seconds() - StartTime;
+
+            UE_LOG(LogTemp, Display, TEXT("Slot kernels, %4d slots: structures %.3f us, columns %.3f us per count+search (%.1fx)%s"),
+                NumSlots,
+                StructureSeconds * 1.0e6 / Iterations,
+                ColumnSeconds * 1.0e6 / Iterations,
+                ColumnSeconds > 0.0 ? StructureSeconds / ColumnSeconds : 0.0,
+                Checksum == 0 ? TEXT("") : TEXT(" MISMATCH"));
+        }
+    }
+
+    FAutoConsoleCommand SlotKernelBenchmarkCommand(
+        TEXT("SurvivalGame.BenchmarkSlotKernels"),
+        TEXT("Compare container slot searches over FItemStructure arrays and slot columns at 20, 200 and 2000 slots"),
+        FConsoleCommandDelegate::CreateStatic(&RunSlotKernelBenchmark));
+}
+#endif
@@ -0,0 +1,201 @@
+// HierarchicalTimerWheel.cpp
+
+#include "Core/HierarchicalTimerWheel.h"
+
+FHierarchicalTimerWheel::FHierarchicalTimerWheel(double InTickSeconds)
+    : TickSeconds(FMath::Max(InTickSeconds, UE_DOUBLE_KINDA_SMALL_NUMBER))
+{
+    for (int32& Head : Heads)
+    {
+        Head = INDEX_NONE;
+    }
+}
+
+FWheelTimerId FHierarchicalTimerWheel::Schedule(double DelaySeconds, uint64 Payload)
+{
+    int32 NodeIndex = FreeList;
+    if (NodeIndex != INDEX_NONE)
+    {
+        FreeList = Nodes[NodeIndex].Next;
+    }
+    else
+    {
+        NodeIndex = Nodes.AddDefaulted();
+    }
+
+    // Round up so a timer never fires early, and never in the tick that is being processed
+    const uint64 DelayTicks = FMath::Max<uint64>(static_cast<uint64>(FMath::CeilToDouble(FMath::Max(DelaySeconds, 0.0) / TickSeconds)), 1);
+
+    FNode& Node = Nodes[NodeIndex];
+    Node.ExpireTick = CurrentTick + DelayTicks;
+    Node.Payload = Payload;
+    Link(NodeIndex);
+    ++NumScheduled;
+
+    FWheelTimerId TimerId;
+    TimerId.Index = NodeIndex;
+    TimerId.Generation = Node.Generation;
+    return TimerId;
+}
+
+bool FHierarchicalTimerWheel::Cancel(FWheelTimerId& TimerId)
+{
+    if (!IsScheduled(TimerId))
+    {
+        TimerId.Invalidate();
+        return false;
+    }
+
+    Unlink(TimerId.Index);
+    Release(TimerId.Index);
+    TimerId.Invalidate();
+    return true;
+}
+
+bool FHierarchicalTimerWheel::IsScheduled(const FWheelTimerId& TimerId) const
+{
+    return Nodes.IsValidIndex(TimerId.Index) &&
+           Nodes[TimerId.Index].Generation == TimerId.Generation &&
+           Nodes[TimerId.Index].Bucket != INDEX_NONE;
+}
+
+double FHierarchicalTimerWheel::GetRemainingSeconds(const FWheelTimerId& TimerId) const
+{
+    if (!IsScheduled(TimerId))
+    {
+        return 0.0;
+    }
+
+    const double RemainingTicks = static_cast<double>(Nodes[TimerId.Index].ExpireTick - CurrentTick);
+    return FMath::Max(RemainingTicks * TickSeconds - PendingSeconds, 0.0);
+}
+
+void FHierarchicalTimerWheel::Advance(double DeltaSeconds, TArray<uint64>& OutExpired)
+{
+    PendingSeconds += FMath::Max(DeltaSeconds, 0.0);
+    uint64 TicksToRun = static_cast<uint64>(PendingSeconds / TickSeconds);
+    PendingSeconds -= static_cast<double>(TicksToRun) * TickSeconds;
+
+    while (TicksToRun > 0)
+    {
+        // An empty wheel has nothing to cascade, so the clock can jump
+        if (NumScheduled == 0)
+        {
+            CurrentTick += TicksToRun;
+            return;
+        }
+
+        ProcessTick(OutExpired);
+        --TicksToRun;
+    }
+}
+
+void FHierarchicalTimerWheel::ProcessTick(TArray<uint64>& OutExpired)
+{
+    ++CurrentTick;
+
+    // When a level wraps, the next slot of the level above is spread over the levels below
+    for (int32 Level = 1; Level < NumLevels; ++Level)
+    {
+        if ((CurrentTick & ((uint64(1) << (Level * SlotBits)) - 1)) != 0)
+        {
+            break;
+        }
+        Cascade(Level);
+    }
+
+    const int32 Bucket = static_cast<int32>(CurrentTick & SlotMask);
+    int32 NodeIndex = Heads[Bucket];
+    Heads[Bucket] = INDEX_NONE;
+
+    while (NodeIndex != INDEX_NONE)
+    {
+        FNode& Node = Nodes[NodeIndex];
+        const int32 NextIndex = Node.Next;
+        Node.Bucket = INDEX_NONE;
+
+        if (Node.ExpireTick <= CurrentTick)
+        {
+            OutExpired.Add(Node.Payload);
+            Release(NodeIndex);
+        }
+        else
+        {
+            // Beyond the top level's range, goes around again
+            Link(NodeIndex);
+        }
+        NodeIndex = NextIndex;
+    }
+}
+
+void FHierarchicalTimerWheel::Cascade(int32 Level)
+{
+    const int32 Bucket = Level * SlotsPerLevel + static_cast<int32>((CurrentTick >> (Level * SlotBits)) & SlotMask);
+    int32 NodeIndex = Heads[Bucket];
+    Heads[Bucket] = INDEX_NONE;
+
+    while (NodeIndex != INDEX_NONE)
+    {
+        const int32 NextIndex = Nodes[NodeIndex].Next;
+        Nodes[NodeIndex].Bucket = INDEX_NONE;
+        Link(NodeIndex);
+        NodeIndex = NextIndex;
+    }
+}
+
+void FHierarchicalTimerWheel::Link(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    const uint64 Delta = Node.ExpireTick > CurrentTick ? Node.ExpireTick - CurrentTick : 0;
+
+    // Pick the lowest level whose range covers the delay, the top level wraps far timers
+    int32 Level = 0;
+    while (Level < NumLevels - 1 && Delta >= (uint64(1) << ((Level + 1) * SlotBits)))
+    {
+        ++Level;
+    }
+
+    const uint64 MaxTick = CurrentTick + (uint64(1) << (NumLevels * SlotBits)) - 1;
+    const uint64 SlotTick = FMath::Min(Node.ExpireTick, MaxTick);
+    const int32 Bucket = Level * SlotsPerLevel + static_cast<int32>((SlotTick >> (Level * SlotBits)) & SlotMask);
+
+    Node.Bucket = Bucket;
+    Node.Prev = INDEX_NONE;
+    Node.Next = Heads[Bucket];
+    if (Node.Next != INDEX_NONE)
+    {
+        Nodes[Node.Next].Prev = NodeIndex;
+    }
+    Heads[Bucket] = NodeIndex;
+}
+
+void FHierarchicalTimerWheel::Unlink(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    if (Node.Prev != INDEX_NONE)
+    {
+        Nodes[Node.Prev].Next = Node.Next;
+    }
+    else
+    {
+        Heads[Node.Bucket] = Node.Next;
+    }
+
+    if (Node.Next != INDEX_NONE)
+    {
+        Nodes[Node.Next].Prev = Node.Prev;
+    }
+
+    Node.Bucket = INDEX_NONE;
+}
+
+void FHierarchicalTimerWheel::Release(int32 NodeIndex)
+{
+    FNode& Node = Nodes[NodeIndex];
+    Node.Bucket = INDEX_NONE;
+    Node.Prev = INDEX_NONE;
+    Node.Next = FreeList;
+    ++Node.Generation;
+    FreeList = NodeIndex;
+    --NumScheduled;
+}
@@ -20,7 +20,9 @@ void USurvivalGameInstance::Init()
 
 void USurvivalGameInstance::InitializeSystems()
 {
-    // Create and initialize the item registry
+    // Create and initialize the item registry. Items are discovered from the manifest and load
+    // on first use, listed default items outside it keep streaming in while the first map
+    // loads and anything that needs them waits for OnItemRegistryInitialized
     ItemRegistry = NewObject<UItemRegistry>(this);
     if (ensure(ItemRegistry))
     {
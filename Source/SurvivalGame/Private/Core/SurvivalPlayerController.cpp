@@ -1,6 +1,8 @@
 #include "Core/SurvivalPlayerController.h"
 #include "EnhancedInputComponent.h"
 #include "UI/Widgets/MasterUILayout.h"
+#include "Core/SurvivalGameInstance.h"
+#include "Registry/ItemRegistry.h"
 #include "Net/UnrealNetwork.h"
 
 ASurvivalPlayerController::ASurvivalPlayerController()
@@ -17,6 +19,63 @@ void ASurvivalPlayerController::GetLifetimeReplicatedProps(TArray<FLifetimePrope
 void ASurvivalPlayerController::BeginPlay()
 {
     Super::BeginPlay();
+
+    // Remote players compare item catalogs before handles are used on their connection
+    if (HasAuthority() && !IsLocalController())
+    {
+        const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+        if (UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr)
+        {
+            Registry->CallOrRegister_OnInitialized(FSimpleDelegate::CreateUObject(this, &ASurvivalPlayerController::SendItemCatalog));
+        }
+    }
+}
+
+void ASurvivalPlayerController::SendItemCatalog()
+{
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    const UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    if (Registry)
+    {
+        const int32 NumHandles = Registry->GetNumHandles();
+        Client_VerifyItemCatalog(NumHandles, Registry->GetCatalogChecksum(NumHandles));
+    }
+}
+
+void ASurvivalPlayerController::Client_VerifyItemCatalog_Implementation(int32 NumHandles, uint32 Checksum)
+{
+    // The local registry may still be loading its default items
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    if (UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr)
+    {
+        Registry->CallOrRegister_OnInitialized(FSimpleDelegate::CreateUObject(this, &ASurvivalPlayerController::VerifyItemCatalog, NumHandles, Checksum));
+    }
+}
+
+void ASurvivalPlayerController::VerifyItemCatalog(int32 NumHandles, uint32 Checksum)
+{
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    const UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    if (!Registry || NumHandles <= 1 || Registry->GetCatalogChecksum(NumHandles) != Checksum)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Item catalog differs from the server's (%d handles, checksum %08x), items are sent by registry key"),
+            NumHandles, Checksum);
+        return;
+    }
+
+    NumVerifiedItemHandles = NumHandles;
+    Server_ConfirmItemCatalog(NumHandles, Checksum);
+}
+
+void ASurvivalPlayerController::Server_ConfirmItemCatalog_Implementation(int32 NumHandles, uint32 Checksum)
+{
+    // Checked against our own table again rather than trusting the client's answer
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    const UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    if (Registry && NumHandles > 1 && Registry->GetCatalogChecksum(NumHandles) == Checksum)
+    {
+        NumVerifiedItemHandles = NumHandles;
+    }
 }
 
 void ASurvivalPlayerController::SetupInputComponent()
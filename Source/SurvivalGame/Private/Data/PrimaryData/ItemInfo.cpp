@@ -1,6 +1,14 @@
 // ItemInfo.cpp
 
 #include "SurvivalGame/Public/Data/PrimaryData/ItemInfo.h"
+#include "SurvivalGame/Public/Registry/ItemManifest.h"
+#include "UObject/AssetRegistryTagsContext.h"
+
+const FPrimaryAssetType UItemInfo::PrimaryAssetType(TEXT("ItemInfo"));
+const FName UItemInfo::RegistryKeyTag(TEXT("RegistryKey"));
+const FName UItemInfo::ItemTagsTag(TEXT("ItemTags"));
+const FName UItemInfo::ItemIconTag(TEXT("ItemIcon"));
+const FName UItemInfo::PrototypeTag(TEXT("ItemPrototype"));
 
 UItemInfo::UItemInfo()
 {
@@ -29,6 +37,7 @@ UItemInfo::UItemInfo()
 
     // Initialize Physical Properties
     WeightClass = E_WeightClass::Light;
+    UnitWeight = 1.0f;
 
     // Initialize Special Properties
     bIsQuestItem = false;
@@ -40,74 +49,118 @@ UItemInfo::UItemInfo()
 
 FPrimaryAssetId UItemInfo::GetPrimaryAssetId() const
 {
-    return FPrimaryAssetId(FPrimaryAssetType("Item"), GetFName());
+    return FPrimaryAssetId(PrimaryAssetType, GetFName());
 }
 
 FName UItemInfo::GetRegistryKey() const
 {
-    return FName(*FString::Printf(TEXT("ItemKey_%s"), *GetName()));
+    if (CachedRegistryKey.IsNone())
+    {
+        CachedRegistryKey = FName(*FString::Printf(TEXT("ItemKey_%s"), *GetName()));
+    }
+    return CachedRegistryKey;
 }
 
-void UItemInfo::LoadItemAssets(const FOnItemAssetsLoadedDelegate& OnAssetsLoaded)
+void UItemInfo::PostRename(UObject* OldOuter, const FName OldName)
 {
-    OnItemAssetsLoadedCallback = OnAssetsLoaded;
+    Super::PostRename(OldOuter, OldName);
 
-    // Create array of assets to load
-    TArray<FSoftObjectPath> AssetsToLoad;
+    CachedRegistryKey = NAME_None;
+    ++DefinitionVersion;
+}
 
-    // Add all asset references that aren't already loaded
-    auto AddAssetIfNotNull = [&AssetsToLoad](const TSoftObjectPtr<UObject>& Asset) {
-        if (!Asset.IsNull()) {
-            AssetsToLoad.Add(Asset.ToSoftObjectPath());
-        }
-    };
+void UItemInfo::GetAssetRegistryTags(FAssetRegistryTagsContext Context) const
+{
+    Super::GetAssetRegistryTags(Context);
 
-    AddAssetIfNotNull(ItemIcon);
-    AddAssetIfNotNull(ItemMesh);
-    AddAssetIfNotNull(ItemSkeletalMesh);
-    AddAssetIfNotNull(ItemParticle);
-    AddAssetIfNotNull(ItemPickupSound);
-    AddAssetIfNotNull(ItemUseSound);
-    AddAssetIfNotNull(ItemDropSound);
+    // Type, category, rarity, weight and value are tagged through AssetRegistrySearchable
+    Context.AddTag(FAssetRegistryTag(RegistryKeyTag, GetRegistryKey().ToString(), FAssetRegistryTag::TT_Alphabetical));
+    Context.AddTag(FAssetRegistryTag(ItemTagsTag, ItemTags.ToStringSimple(), FAssetRegistryTag::TT_Hidden));
+    Context.AddTag(FAssetRegistryTag(ItemIconTag, ItemIcon.ToString(), FAssetRegistryTag::TT_Hidden));
 
-    if (AssetsToLoad.Num() > 0)
-    {
-        FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
-        Streamable.RequestAsyncLoad(AssetsToLoad, FStreamableDelegate::CreateUObject(this, &UItemInfo::OnItemAssetsLoaded));
-    }
-    else
+    // Lets the registry build instances (on clients, while decoding replicated items) without loading this asset
+    Context.AddTag(FAssetRegistryTag(PrototypeTag, FItemManifestEntry::ExportPrototype(BuildPrototype()), FAssetRegistryTag::TT_Hidden));
+}
+
+#if WITH_EDITOR
+void UItemInfo::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    ++DefinitionVersion;
+}
+#endif
+
+FSoftObjectPath UItemInfo::GetAssetPath(E_ItemAssetKind Kind) const
+{
+    switch (Kind)
     {
-        OnItemAssetsLoaded();
+    case E_ItemAssetKind::Icon:           return ItemIcon.ToSoftObjectPath();
+    case E_ItemAssetKind::Mesh:           return ItemMesh.ToSoftObjectPath();
+    case E_ItemAssetKind::SkeletalMesh:   return ItemSkeletalMesh.ToSoftObjectPath();
+    case E_ItemAssetKind::Particle:       return ItemParticle.ToSoftObjectPath();
+    case E_ItemAssetKind::PickupSound:    return ItemPickupSound.ToSoftObjectPath();
+    case E_ItemAssetKind::UseSound:       return ItemUseSound.ToSoftObjectPath();
+    case E_ItemAssetKind::DropSound:      return ItemDropSound.ToSoftObjectPath();
+    default:                              return FSoftObjectPath();
     }
 }
 
-void UItemInfo::OnItemAssetsLoaded()
+void UItemInfo::LoadItemAssets(const FOnItemAssetsLoadedDelegate& OnAssetsLoaded)
 {
-    // Cache loaded assets
-    LoadedAssets.Empty();
+    UItemAssetCache* Cache = UItemAssetCache::Get();
+    if (!Cache)
+    {
+        OnAssetsLoaded.ExecuteIfBound();
+        return;
+    }
 
-    auto CacheAssetIfNotNull = [this](const TSoftObjectPtr<UObject>& Asset) {
-        if (!Asset.IsNull()) {
-            LoadedAssets.Add(Asset.Get());
+    // One count per request plus one for this loop, so assets that are already resident and
+    // call back immediately cannot fire the delegate before every request was made
+    TSharedRef<int32> Remaining = MakeShared<int32>(1);
+    auto OnAssetDone = [Remaining, OnAssetsLoaded]()
+    {
+        if (--(*Remaining) == 0)
+        {
+            OnAssetsLoaded.ExecuteIfBound();
         }
     };
 
-    CacheAssetIfNotNull(ItemIcon);
-    CacheAssetIfNotNull(ItemMesh);
-    CacheAssetIfNotNull(ItemSkeletalMesh);
-    CacheAssetIfNotNull(ItemParticle);
-    CacheAssetIfNotNull(ItemPickupSound);
-    CacheAssetIfNotNull(ItemUseSound);
-    CacheAssetIfNotNull(ItemDropSound);
+    TArray<FItemAssetHandle> Handles;
+    for (E_ItemAssetKind Kind : TEnumRange<E_ItemAssetKind>())
+    {
+        if (GetAssetPath(Kind).IsNull())
+        {
+            continue;
+        }
+
+        ++(*Remaining);
+        Handles.Add(Cache->RequestItemAsset(this, Kind, UItemAssetCache::DefaultPriority, FSimpleDelegate::CreateLambda(OnAssetDone)));
+    }
 
-    // Execute the Blueprint callback if bound
-    if (OnItemAssetsLoadedCallback.IsBound())
+    // The first call keeps the assets resident. Later ones share those entries, so dropping
+    // their handles cannot cancel a load the callback is still waiting on.
+    if (AssetHandles.IsEmpty())
     {
-        OnItemAssetsLoadedCallback.Execute();
+        AssetHandles = MoveTemp(Handles);
     }
+
+    OnAssetDone();
+}
+
+void UItemInfo::ReleaseItemAssets()
+{
+    AssetHandles.Reset();
 }
 
 FItemStructure UItemInfo::CreateItemInstance(int32 Quantity) const
+{
+    FItemStructure NewItem = BuildPrototype();
+    NewItem.ItemQuantity = FMath::Clamp(Quantity, 1, bIsStackable ? MaxStackSize : 1);
+    return NewItem;
+}
+
+FItemStructure UItemInfo::BuildPrototype() const
 {
     FItemStructure NewItem;
 
@@ -123,7 +176,7 @@ FItemStructure UItemInfo::CreateItemInstance(int32 Quantity) const
     // Set Stack Properties
     NewItem.bIsStackable = bIsStackable;
     NewItem.MaxStackSize = MaxStackSize;
-    NewItem.ItemQuantity = FMath::Clamp(Quantity, 1, bIsStackable ? MaxStackSize : 1);
+    NewItem.ItemQuantity = 1;
 
     // Set Equipment Properties
     NewItem.bIsEquippable = bIsEquippable;
@@ -1,6 +1,42 @@
 // ItemStructure.cpp
 
 #include "SurvivalGame/Public/Data/Struct/ItemStructure.h"
+#include "SurvivalGame/Public/Registry/ItemRegistry.h"
+
+namespace ItemStructureNet
+{
+    /** E_ItemState fits in 3 bits */
+    constexpr uint32 ItemStateWireMax = 8;
+
+    FORCEINLINE bool SerializeBit(FArchive& Ar, bool bValue)
+    {
+        uint8 Bit = bValue ? 1 : 0;
+        Ar.SerializeBits(&Bit, 1);
+        return Bit != 0;
+    }
+
+    FORCEINLINE bool ModifiersMatch(const FItemModifier& A, const FItemModifier& B)
+    {
+        return A.ModifierValue == B.ModifierValue && A.ModifierName == B.ModifierName;
+    }
+
+    bool ModifiersDifferFromDefaults(const FItemStructure& Item)
+    {
+        if (Item.ItemModifiers.Num() != Item.DefaultModifiers.Num())
+        {
+            return true;
+        }
+
+        for (int32 i = 0; i < Item.ItemModifiers.Num(); ++i)
+        {
+            if (!ModifiersMatch(Item.ItemModifiers[i], Item.DefaultModifiers[i]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
 
 FItemStructure::FItemStructure()
     : RegistryKey(NAME_None)
@@ -18,6 +54,7 @@ FItemStructure::FItemStructure()
     , CurrentDurability(100)
     , MaxDurability(100)
     , DurabilityDecayRate(0.0f)
+    , DecayTimestamp(0.0)
     , bIsDestroyable(true)
     , WeightClass(E_WeightClass::Light)
     , bIsQuestItem(false)
@@ -59,9 +96,251 @@ void FItemStructure::InitializeFromData(const FItemStructure& LoadedItem)
     CurrentDurability = bHasDurability ? MaxDurability : 0;
 }
 
+int32 FItemStructure::GetDurabilityAt(double Time) const
+{
+    if (!IsDecaying())
+    {
+        return CurrentDurability;
+    }
+
+    const double Elapsed = FMath::Max(Time - DecayTimestamp, 0.0);
+    const int64 Lost = static_cast<int64>(Elapsed * DurabilityDecayRate);
+    return static_cast<int32>(FMath::Max<int64>(CurrentDurability - Lost, 0));
+}
+
+double FItemStructure::GetDecayExpiryTime() const
+{
+    return IsDecaying() ? DecayTimestamp + CurrentDurability / static_cast<double>(DurabilityDecayRate) : MAX_dbl;
+}
+
+bool FItemStructure::ApplyDecay(double Time)
+{
+    if (!IsDecaying())
+    {
+        return false;
+    }
+
+    const int32 Lost = CurrentDurability - GetDurabilityAt(Time);
+    if (Lost <= 0)
+    {
+        return false;
+    }
+
+    CurrentDurability -= Lost;
+    DecayTimestamp += Lost / static_cast<double>(DurabilityDecayRate);
+
+    // Food and other raw or processed goods spoil, everything else breaks
+    if (CurrentDurability <= 0)
+    {
+        ItemState = (ItemState == E_ItemState::Raw || ItemState == E_ItemState::Processed)
+            ? E_ItemState::Spoiled
+            : E_ItemState::Broken;
+    }
+    return true;
+}
+
+void FItemStructure::MergeDecay(const FItemStructure& Other, int32 Quantity, double Time)
+{
+    if (!bHasDurability || DurabilityDecayRate <= 0.0f || Quantity <= 0)
+    {
+        return;
+    }
+
+    // Blend remaining lifetimes rather than keeping either clock, rounding keeps it above zero
+    const bool bClockStarted = IsDecaying() || Other.IsDecaying();
+    const int64 Ours = static_cast<int64>(GetDurabilityAt(Time)) * FMath::Max(ItemQuantity, 0);
+    const int64 Theirs = static_cast<int64>(Other.GetDurabilityAt(Time)) * Quantity;
+    const int64 Total = FMath::Max(ItemQuantity, 0) + static_cast<int64>(Quantity);
+    CurrentDurability = static_cast<int32>((Ours + Theirs + Total / 2) / Total);
+
+    if (bClockStarted)
+    {
+        DecayTimestamp = FMath::Max(Time, UE_DOUBLE_SMALL_NUMBER);
+    }
+}
+
 bool FItemStructure::operator==(const FItemStructure& Other) const
 {
     return RegistryKey == Other.RegistryKey &&
            ItemQuantity == Other.ItemQuantity &&
            ItemState == Other.ItemState;
+}
+
+bool FItemStructure::IsIdenticalInstance(const FItemStructure& Other) const
+{
+    if (!(*this == Other) ||
+        bHasDurability != Other.bHasDurability ||
+        CurrentDurability != Other.CurrentDurability ||
+        MaxDurability != Other.MaxDurability ||
+        DecayTimestamp != Other.DecayTimestamp ||
+        ItemModifiers.Num() != Other.ItemModifiers.Num())
+    {
+        return false;
+    }
+
+    for (int32 i = 0; i < ItemModifiers.Num(); ++i)
+    {
+        if (!ItemStructureNet::ModifiersMatch(ItemModifiers[i], Other.ItemModifiers[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FItemStructure::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    using namespace ItemStructureNet;
+
+    // Empty slots cost a single bit
+    if (SerializeBit(Ar, IsEmpty()))
+    {
+        if (Ar.IsLoading())
+        {
+            *this = FItemStructure();
+        }
+        bOutSuccess = true;
+        return true;
+    }
+
+    // The handle stands in for the key once both ends verified they number it the same way
+    FName WireKey = RegistryKey;
+    FItemHandle WireHandle = ItemHandle;
+    if (SerializeBit(Ar, Ar.IsSaving() && UItemRegistry::IsHandleVerified(Map, ItemHandle)))
+    {
+        WireHandle.NetSerialize(Ar, Map, bOutSuccess);
+    }
+    else
+    {
+        Ar << WireKey;
+        WireHandle.Reset();
+    }
+
+    uint32 WireQuantity = static_cast<uint32>(FMath::Max(ItemQuantity, 0));
+    Ar.SerializeIntPacked(WireQuantity);
+
+    // Durability is sent against its own max so the value stays exact
+    const bool bWireHasDurability = SerializeBit(Ar, bHasDurability);
+    uint32 WireMaxDurability = static_cast<uint32>(FMath::Max(MaxDurability, 1));
+    uint32 WireDurability = 0;
+    double WireDecayTimestamp = 0.0;
+    if (bWireHasDurability)
+    {
+        Ar.SerializeIntPacked(WireMaxDurability);
+        WireMaxDurability = FMath::Max(WireMaxDurability, 1u);
+        WireDurability = WireMaxDurability;
+
+        if (SerializeBit(Ar, CurrentDurability < MaxDurability))
+        {
+            WireDurability = static_cast<uint32>(FMath::Clamp(CurrentDurability, 0, MaxDurability));
+            Ar.SerializeInt(WireDurability, WireMaxDurability + 1);
+        }
+
+        // With the timestamp, clients derive current durability themselves and the
+        // slot never has to be re-sent while it decays
+        if (SerializeBit(Ar, DecayTimestamp > 0.0))
+        {
+            WireDecayTimestamp = DecayTimestamp;
+            Ar << WireDecayTimestamp;
+        }
+    }
+
+    uint32 WireState = static_cast<uint32>(ItemState);
+    Ar.SerializeInt(WireState, ItemStateWireMax);
+
+    if (Ar.IsLoading())
+    {
+        // Rebuild static data from the item definition, then apply the instance state
+        FItemStructure Rebuilt;
+        if (const UItemRegistry* Registry = UItemRegistry::GetForPackageMap(Map))
+        {
+            Rebuilt = WireHandle.IsValid()
+                ? Registry->CreateItemInstanceFromHandle(WireHandle, 1)
+                : Registry->CreateItemInstance(WireKey, 1);
+        }
+
+        if (Rebuilt.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("NetSerialize: item %s (handle %d) is not in the item registry, static data will be missing"),
+                *WireKey.ToString(), WireHandle.GetIndex());
+            Rebuilt.RegistryKey = WireKey;
+            Rebuilt.ItemHandle = WireHandle;
+        }
+
+        Rebuilt.ItemQuantity = static_cast<int32>(WireQuantity);
+        Rebuilt.bHasDurability = bWireHasDurability;
+        if (bWireHasDurability)
+        {
+            Rebuilt.MaxDurability = static_cast<int32>(WireMaxDurability);
+            Rebuilt.CurrentDurability = static_cast<int32>(WireDurability);
+            Rebuilt.DecayTimestamp = WireDecayTimestamp;
+        }
+        Rebuilt.ItemState = static_cast<E_ItemState>(WireState);
+
+        *this = MoveTemp(Rebuilt);
+    }
+
+    // Modifiers are only sent when they differ from the definition defaults
+    if (SerializeBit(Ar, ModifiersDifferFromDefaults(*this)))
+    {
+        uint32 NumModifiers = static_cast<uint32>(ItemModifiers.Num());
+        Ar.SerializeIntPacked(NumModifiers);
+
+        if (Ar.IsLoading())
+        {
+            // Guard against malformed input before allocating
+            if (NumModifiers > 255)
+            {
+                Ar.SetError();
+                bOutSuccess = false;
+                return true;
+            }
+            ItemModifiers.SetNum(static_cast<int32>(NumModifiers));
+        }
+
+        for (int32 i = 0; i < ItemModifiers.Num(); ++i)
+        {
+            FItemModifier& Modifier = ItemModifiers[i];
+            const FItemModifier* Default = DefaultModifiers.IsValidIndex(i) ? &DefaultModifiers[i] : nullptr;
+
+            // A sender whose definition has more defaults than ours (stale client, mismatched
+            // catalog) can refer to one we do not have, the packet cannot be decoded then
+            if (SerializeBit(Ar, Default && ModifiersMatch(Modifier, *Default)))
+            {
+                if (Ar.IsLoading())
+                {
+                    if (!Default)
+                    {
+                        Ar.SetError();
+                        bOutSuccess = false;
+                        return true;
+                    }
+                    Modifier = *Default;
+                }
+                continue;
+            }
+
+            if (SerializeBit(Ar, Default && Modifier.ModifierName == Default->ModifierName))
+            {
+                if (Ar.IsLoading())
+                {
+                    if (!Default)
+                    {
+                        Ar.SetError();
+                        bOutSuccess = false;
+                        return true;
+                    }
+                    Modifier.ModifierName = Default->ModifierName;
+                }
+            }
+            else
+            {
+                Ar << Modifier.ModifierName;
+            }
+            Ar << Modifier.ModifierValue;
+        }
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
 }
\ No newline at end of file
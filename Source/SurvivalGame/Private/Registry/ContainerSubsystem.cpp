@@ -0,0 +1,373 @@
+// ContainerSubsystem.cpp
+
+#include "Registry/ContainerSubsystem.h"
+#include "Components/Inventory/ItemContainerBase.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+UContainerSubsystem* UContainerSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UContainerSubsystem>() : nullptr;
+}
+
+void UContainerSubsystem::Deinitialize()
+{
+    for (FContainerEntry& Entry : Entries)
+    {
+        if (USceneComponent* Root = Entry.TrackedRoot.Get())
+        {
+            Root->TransformUpdated.Remove(Entry.TransformHandle);
+        }
+
+        if (UItemContainerBase* Container = Entry.Container.Get())
+        {
+            Container->ContainerId = INDEX_NONE;
+        }
+    }
+
+    Entries.Empty();
+    EntryLookup.Empty();
+    IdLookup.Empty();
+    DenseContainers.Empty();
+    DenseEntries.Empty();
+    for (TArray<UItemContainerBase*>& Bucket : ContainersByType)
+    {
+        Bucket.Empty();
+    }
+    ContainersByOwner.Empty();
+    DirtyContainerIds.Empty();
+    Cells.Empty();
+
+    Super::Deinitialize();
+}
+
+void UContainerSubsystem::RegisterContainer(UItemContainerBase* Container)
+{
+    AActor* Host = Container ? Container->GetOwner() : nullptr;
+    if (!Host || EntryLookup.Contains(Container))
+    {
+        return;
+    }
+
+    const int32 EntryIndex = Entries.Add(FContainerEntry());
+    FContainerEntry& Entry = Entries[EntryIndex];
+    Entry.Container = Container;
+    Entry.ContainerId = NextContainerId++;
+    Entry.ContainerType = Container->GetContainerType();
+    Entry.OwnerKey = GetOwnerKey(*Container);
+    Entry.Location = Host->GetActorLocation();
+    Entry.Cell = GetCell(Entry.Location);
+
+    Container->ContainerId = Entry.ContainerId;
+    EntryLookup.Add(Container, EntryIndex);
+    IdLookup.Add(Entry.ContainerId, EntryIndex);
+
+    Entry.DenseIndex = DenseContainers.Add(Container);
+    DenseEntries.Add(EntryIndex);
+    ContainersByType[static_cast<int32>(Entry.ContainerType)].Add(Container);
+    ContainersByOwner.FindOrAdd(Entry.OwnerKey).Add(Container);
+    AddToCell(EntryIndex);
+
+    // Changes made before registration (e.g. during initialization) still count
+    if (Container->bDirtyInRegistry)
+    {
+        DirtyContainerIds.Add(Entry.ContainerId);
+    }
+
+    // Possession is how hosts usually change owner, and pawns announce it
+    if (APawn* Pawn = Cast<APawn>(Host))
+    {
+        Pawn->ReceiveControllerChangedDelegate.AddUniqueDynamic(this, &UContainerSubsystem::HandlePawnControllerChanged);
+    }
+
+    // Static chests never move, only movable roots need tracking
+    USceneComponent* Root = Host->GetRootComponent();
+    if (Root && Root->Mobility == EComponentMobility::Movable)
+    {
+        Entry.TrackedRoot = Root;
+        Entry.TransformHandle = Root->TransformUpdated.AddUObject(this, &UContainerSubsystem::HandleRootTransformUpdated, EntryIndex);
+    }
+}
+
+void UContainerSubsystem::UnregisterContainer(UItemContainerBase* Container)
+{
+    int32 EntryIndex = INDEX_NONE;
+    if (!EntryLookup.RemoveAndCopyValue(Container, EntryIndex))
+    {
+        return;
+    }
+
+    FContainerEntry& Entry = Entries[EntryIndex];
+    if (USceneComponent* Root = Entry.TrackedRoot.Get())
+    {
+        Root->TransformUpdated.Remove(Entry.TransformHandle);
+    }
+
+    // Swap the last dense element into the hole and fix its back reference
+    const int32 DenseIndex = Entry.DenseIndex;
+    DenseContainers.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    DenseEntries.RemoveAtSwap(DenseIndex, 1, EAllowShrinking::No);
+    if (DenseEntries.IsValidIndex(DenseIndex))
+    {
+        Entries[DenseEntries[DenseIndex]].DenseIndex = DenseIndex;
+    }
+
+    ContainersByType[static_cast<int32>(Entry.ContainerType)].RemoveSingleSwap(Container, EAllowShrinking::No);
+    RemoveFromOwnerBucket(Entry.OwnerKey, Container);
+    RemoveFromCell(EntryIndex);
+
+    IdLookup.Remove(Entry.ContainerId);
+    Container->ContainerId = INDEX_NONE;
+    Entries.RemoveAt(EntryIndex);
+
+    // The pawn binding is shared by every container on the pawn
+    if (APawn* Pawn = Cast<APawn>(Container->GetOwner()))
+    {
+        TInlineComponentArray<UItemContainerBase*> PawnContainers(Pawn);
+        const bool bOthersRegistered = PawnContainers.ContainsByPredicate([this](const UItemContainerBase* Other)
+        {
+            return EntryLookup.Contains(Other);
+        });
+        if (!bOthersRegistered)
+        {
+            Pawn->ReceiveControllerChangedDelegate.RemoveDynamic(this, &UContainerSubsystem::HandlePawnControllerChanged);
+        }
+    }
+}
+
+void UContainerSubsystem::UpdateContainerOwner(UItemContainerBase* Container)
+{
+    const int32* EntryIndex = EntryLookup.Find(Container);
+    if (!EntryIndex)
+    {
+        return;
+    }
+
+    FContainerEntry& Entry = Entries[*EntryIndex];
+    const TObjectKey<AActor> NewOwnerKey = GetOwnerKey(*Container);
+    if (NewOwnerKey != Entry.OwnerKey)
+    {
+        RemoveFromOwnerBucket(Entry.OwnerKey, Container);
+        Entry.OwnerKey = NewOwnerKey;
+        ContainersByOwner.FindOrAdd(NewOwnerKey).Add(Container);
+    }
+}
+
+void UContainerSubsystem::MarkContainerDirty(UItemContainerBase* Container)
+{
+    if (!Container || Container->bDirtyInRegistry)
+    {
+        return;
+    }
+
+    // Only the clean to dirty transition is recorded, repeated writes cost nothing
+    Container->bDirtyInRegistry = true;
+    if (Container->ContainerId != INDEX_NONE)
+    {
+        DirtyContainerIds.Add(Container->ContainerId);
+    }
+}
+
+void UContainerSubsystem::ConsumeDirtyContainers(TArray<UItemContainerBase*>& OutContainers)
+{
+    OutContainers.Reset();
+    OutContainers.Reserve(DirtyContainerIds.Num());
+
+    for (const int32 ContainerId : DirtyContainerIds)
+    {
+        // Containers unregistered since they were marked are skipped
+        if (UItemContainerBase* Container = FindContainerById(ContainerId))
+        {
+            Container->bDirtyInRegistry = false;
+            OutContainers.Add(Container);
+        }
+    }
+    DirtyContainerIds.Reset();
+}
+
+UItemContainerBase* UContainerSubsystem::FindContainerById(int32 ContainerId) const
+{
+    const int32* EntryIndex = IdLookup.Find(ContainerId);
+    return EntryIndex ? Entries[*EntryIndex].Container.Get() : nullptr;
+}
+
+TConstArrayView<UItemContainerBase*> UContainerSubsystem::GetContainersOfType(E_ContainerType ContainerType) const
+{
+    const int32 TypeIndex = static_cast<int32>(ContainerType);
+    return TypeIndex < UE_ARRAY_COUNT(ContainersByType) ? TConstArrayView<UItemContainerBase*>(ContainersByType[TypeIndex]) : TConstArrayView<UItemContainerBase*>();
+}
+
+TConstArrayView<UItemContainerBase*> UContainerSubsystem::GetContainersOwnedBy(const AActor* Owner) const
+{
+    const TArray<UItemContainerBase*>* Bucket = ContainersByOwner.Find(TObjectKey<AActor>(Owner));
+    return Bucket ? TConstArrayView<UItemContainerBase*>(*Bucket) : TConstArrayView<UItemContainerBase*>();
+}
+
+void UContainerSubsystem::FindContainersInRadius(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter, TArray<UItemContainerBase*>& OutContainers) const
+{
+    OutContainers.Reset();
+
+    TArray<TPair<float, UItemContainerBase*>> Hits;
+    GatherInRadius(Origin, Radius, Filter, Hits);
+    Hits.Sort([](const TPair<float, UItemContainerBase*>& A, const TPair<float, UItemContainerBase*>& B)
+    {
+        return A.Key < B.Key;
+    });
+
+    OutContainers.Reserve(Hits.Num());
+    for (const TPair<float, UItemContainerBase*>& Hit : Hits)
+    {
+        OutContainers.Add(Hit.Value);
+    }
+}
+
+UItemContainerBase* UContainerSubsystem::FindNearestContainer(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter) const
+{
+    TArray<TPair<float, UItemContainerBase*>> Hits;
+    GatherInRadius(Origin, Radius, Filter, Hits);
+
+    const TPair<float, UItemContainerBase*>* Nearest = nullptr;
+    for (const TPair<float, UItemContainerBase*>& Hit : Hits)
+    {
+        if (!Nearest || Hit.Key < Nearest->Key)
+        {
+            Nearest = &Hit;
+        }
+    }
+    return Nearest ? Nearest->Value : nullptr;
+}
+
+void UContainerSubsystem::GatherInRadius(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter, TArray<TPair<float, UItemContainerBase*>>& OutHits) const
+{
+    if (Radius < 0.0f)
+    {
+        return;
+    }
+
+    const float RadiusSq = FMath::Square(Radius);
+    auto TestEntry = [&](const FContainerEntry& Entry)
+    {
+        const float DistSq = FVector::DistSquared(Origin, Entry.Location);
+        UItemContainerBase* Container = Entry.Container.Get();
+        if (DistSq <= RadiusSq && Container && PassesFilter(*Container, Filter))
+        {
+            OutHits.Emplace(DistSq, Container);
+        }
+    };
+
+    const FIntPoint MinCell = GetCell(Origin - FVector(Radius));
+    const FIntPoint MaxCell = GetCell(Origin + FVector(Radius));
+    const int64 NumQueryCells = static_cast<int64>(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1);
+
+    // A radius covering more cells than are occupied is cheaper as a flat scan
+    if (NumQueryCells > Cells.Num())
+    {
+        for (const int32 EntryIndex : DenseEntries)
+        {
+            TestEntry(Entries[EntryIndex]);
+        }
+        return;
+    }
+
+    for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+    {
+        for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+        {
+            if (const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y)))
+            {
+                for (const int32 EntryIndex : *CellEntries)
+                {
+                    TestEntry(Entries[EntryIndex]);
+                }
+            }
+        }
+    }
+}
+
+FIntPoint UContainerSubsystem::GetCell(const FVector& Location)
+{
+    return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+bool UContainerSubsystem::PassesFilter(const UItemContainerBase& Container, const FContainerQueryFilter& Filter)
+{
+    if (Filter.ContainerType != E_ContainerType::None && Container.GetContainerType() != Filter.ContainerType)
+    {
+        return false;
+    }
+
+    const AActor* Host = Container.GetOwner();
+    if (Filter.IgnoreActor && Host == Filter.IgnoreActor)
+    {
+        return false;
+    }
+
+    return !Filter.Owner || (Host && Host->GetOwner() == Filter.Owner);
+}
+
+TObjectKey<AActor> UContainerSubsystem::GetOwnerKey(const UItemContainerBase& Container)
+{
+    const AActor* Host = Container.GetOwner();
+    return TObjectKey<AActor>(Host ? Host->GetOwner() : nullptr);
+}
+
+void UContainerSubsystem::AddToCell(int32 EntryIndex)
+{
+    Cells.FindOrAdd(Entries[EntryIndex].Cell).Add(EntryIndex);
+}
+
+void UContainerSubsystem::RemoveFromCell(int32 EntryIndex)
+{
+    const FIntPoint Cell = Entries[EntryIndex].Cell;
+    if (TArray<int32>* CellEntries = Cells.Find(Cell))
+    {
+        CellEntries->RemoveSingleSwap(EntryIndex);
+        if (CellEntries->Num() == 0)
+        {
+            Cells.Remove(Cell);
+        }
+    }
+}
+
+void UContainerSubsystem::RemoveFromOwnerBucket(const TObjectKey<AActor>& OwnerKey, UItemContainerBase* Container)
+{
+    if (TArray<UItemContainerBase*>* Bucket = ContainersByOwner.Find(OwnerKey))
+    {
+        Bucket->RemoveSingleSwap(Container, EAllowShrinking::No);
+        if (Bucket->Num() == 0)
+        {
+            ContainersByOwner.Remove(OwnerKey);
+        }
+    }
+}
+
+void UContainerSubsystem::HandlePawnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+    // PossessedBy and UnPossessed set the pawn's owner before announcing the new controller
+    TInlineComponentArray<UItemContainerBase*> PawnContainers(Pawn);
+    for (UItemContainerBase* Container : PawnContainers)
+    {
+        UpdateContainerOwner(Container);
+    }
+}
+
+void UContainerSubsystem::HandleRootTransformUpdated(USceneComponent* Root, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport, int32 EntryIndex)
+{
+    if (!Entries.IsValidIndex(EntryIndex) || !Root)
+    {
+        return;
+    }
+
+    FContainerEntry& Entry = Entries[EntryIndex];
+    Entry.Location = Root->GetComponentLocation();
+
+    // Most moves stay inside the cell and only refresh the cached location
+    const FIntPoint NewCell = GetCell(Entry.Location);
+    if (NewCell != Entry.Cell)
+    {
+        RemoveFromCell(EntryIndex);
+        Entry.Cell = NewCell;
+        AddToCell(EntryIndex);
+    }
+}
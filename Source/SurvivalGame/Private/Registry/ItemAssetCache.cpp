@@ -0,0 +1,306 @@
+// ItemAssetCache.cpp
+
+#include "Registry/ItemAssetCache.h"
+#include "Data/PrimaryData/ItemInfo.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+
+FItemAssetReference::FItemAssetReference(UItemAssetCache* InCache, const FSoftObjectPath& InPath)
+    : Cache(InCache)
+    , Path(InPath)
+{
+    InCache->AddReference(Path);
+}
+
+FItemAssetReference::~FItemAssetReference()
+{
+    if (UItemAssetCache* CachePtr = Cache.Get())
+    {
+        CachePtr->Release(Path);
+    }
+}
+
+UObject* FItemAssetHandle::Get() const
+{
+    const UItemAssetCache* Cache = Reference.IsValid() ? Reference->Cache.Get() : nullptr;
+    return Cache ? Cache->FindAsset(Reference->Path) : nullptr;
+}
+
+const FSoftObjectPath& FItemAssetHandle::GetPath() const
+{
+    static const FSoftObjectPath EmptyPath;
+    return Reference.IsValid() ? Reference->Path : EmptyPath;
+}
+
+UItemAssetCache* UItemAssetCache::Get()
+{
+    return GEngine ? GEngine->GetEngineSubsystem<UItemAssetCache>() : nullptr;
+}
+
+void UItemAssetCache::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    BudgetBytes = static_cast<int64>(MemoryBudgetMB) * 1024 * 1024;
+}
+
+void UItemAssetCache::Deinitialize()
+{
+    // Outstanding handles hold a weak pointer and stop releasing into us
+    for (auto& Pair : Entries)
+    {
+        if (Pair.Value.LoadHandle.IsValid())
+        {
+            Pair.Value.LoadHandle->CancelHandle();
+        }
+    }
+    Entries.Empty();
+    PendingPaths.Empty();
+    LruList.Empty();
+    NumLoading = 0;
+    ResidentBytes = 0;
+
+    Super::Deinitialize();
+}
+
+FItemAssetHandle UItemAssetCache::RequestAsset(const FSoftObjectPath& Path, int32 Priority, FSimpleDelegate OnLoaded)
+{
+    FItemAssetHandle Handle;
+    if (Path.IsNull())
+    {
+        return Handle;
+    }
+
+    Handle.Reference = MakeShared<FItemAssetReference>(this, Path);
+
+    FEntry& Entry = Entries.FindChecked(Path);
+    if (Entry.State == EEntryState::Resident || Entry.State == EEntryState::Failed)
+    {
+        OnLoaded.ExecuteIfBound();
+        return Handle;
+    }
+
+    if (OnLoaded.IsBound())
+    {
+        Entry.OnLoaded.Add(MoveTemp(OnLoaded));
+    }
+
+    // A queued entry takes the most urgent priority anyone asked for, once it is with the
+    // streamer its priority is fixed
+    if (Entry.State == EEntryState::Pending)
+    {
+        Entry.Priority = FMath::Max(Entry.Priority, Priority);
+        StartPendingLoads();
+    }
+    return Handle;
+}
+
+FItemAssetHandle UItemAssetCache::RequestItemAsset(const UItemInfo* ItemInfo, E_ItemAssetKind Kind, int32 Priority, FSimpleDelegate OnLoaded)
+{
+    return ItemInfo ? RequestAsset(ItemInfo->GetAssetPath(Kind), Priority, MoveTemp(OnLoaded)) : FItemAssetHandle();
+}
+
+UObject* UItemAssetCache::FindAsset(const FSoftObjectPath& Path) const
+{
+    const FEntry* Entry = Entries.Find(Path);
+    return Entry && Entry->State == EEntryState::Resident ? Entry->Asset.Get() : nullptr;
+}
+
+void UItemAssetCache::SetMemoryBudget(int64 InBudgetBytes)
+{
+    BudgetBytes = FMath::Max<int64>(InBudgetBytes, 0);
+    EnforceBudget();
+}
+
+void UItemAssetCache::AddReference(const FSoftObjectPath& Path)
+{
+    FEntry* Entry = Entries.Find(Path);
+    if (!Entry)
+    {
+        Entry = &Entries.Add(Path);
+        PendingPaths.Add(Path);
+    }
+
+    // Referenced again, no longer a candidate for eviction
+    if (Entry->LruNode)
+    {
+        LruList.RemoveNode(Entry->LruNode);
+        Entry->LruNode = nullptr;
+    }
+    ++Entry->RefCount;
+}
+
+void UItemAssetCache::Release(const FSoftObjectPath& Path)
+{
+    FEntry* Entry = Entries.Find(Path);
+    if (!Entry || --Entry->RefCount > 0)
+    {
+        return;
+    }
+
+    if (Entry->State != EEntryState::Resident)
+    {
+        // Nobody is waiting any more, drop the request instead of finishing it
+        RemoveEntry(Path);
+        StartPendingLoads();
+        return;
+    }
+
+    LruList.AddTail(Path);
+    Entry->LruNode = LruList.GetTail();
+    EnforceBudget();
+}
+
+void UItemAssetCache::StartPendingLoads()
+{
+    FStreamableManager& Streamable = UAssetManager::GetStreamableManager();
+    while (NumLoading < MaxConcurrentLoads && PendingPaths.Num() > 0)
+    {
+        // Queues stay short, a linear scan for the most urgent entry is cheaper than keeping a heap in sync with priority bumps
+        int32 BestIndex = 0;
+        for (int32 Index = 1; Index < PendingPaths.Num(); ++Index)
+        {
+            if (Entries[PendingPaths[Index]].Priority > Entries[PendingPaths[BestIndex]].Priority)
+            {
+                BestIndex = Index;
+            }
+        }
+
+        const FSoftObjectPath Path = PendingPaths[BestIndex];
+        PendingPaths.RemoveAt(BestIndex, EAllowShrinking::No);
+
+        FEntry& Entry = Entries[Path];
+        Entry.State = EEntryState::Loading;
+        ++NumLoading;
+
+        TSharedPtr<FStreamableHandle> LoadHandle = Streamable.RequestAsyncLoad(Path,
+            FStreamableDelegate::CreateUObject(this, &UItemAssetCache::HandleAssetLoaded, Path),
+            Entry.Priority);
+
+        // The completion delegate may already have run (asset in memory) and even removed the entry
+        if (FEntry* Current = Entries.Find(Path))
+        {
+            Current->LoadHandle = LoadHandle;
+            if (!LoadHandle.IsValid() && Current->State == EEntryState::Loading)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("ItemAssetCache: could not request %s"), *Path.ToString());
+                FailEntry(Path);
+            }
+        }
+    }
+}
+
+void UItemAssetCache::HandleAssetLoaded(FSoftObjectPath Path)
+{
+    FEntry* Entry = Entries.Find(Path);
+    if (!Entry || Entry->State != EEntryState::Loading)
+    {
+        return;
+    }
+
+    // Also runs inside RequestAsyncLoad when the asset is already in memory, before the
+    // handle is stored, so resolve the path instead of asking the handle
+    UObject* Asset = Path.ResolveObject();
+    if (!Asset)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemAssetCache: failed to load %s"), *Path.ToString());
+        FailEntry(Path);
+        return;
+    }
+
+    --NumLoading;
+    Entry->State = EEntryState::Resident;
+    Entry->Asset = Asset;
+    Entry->SizeBytes = EstimateSize(Asset);
+    ResidentBytes += Entry->SizeBytes;
+
+    // Waiters may request or release assets, work on a copy
+    TArray<FSimpleDelegate> Callbacks = MoveTemp(Entry->OnLoaded);
+    Entry->OnLoaded.Reset();
+    for (const FSimpleDelegate& Callback : Callbacks)
+    {
+        Callback.ExecuteIfBound();
+    }
+
+    EnforceBudget();
+    StartPendingLoads();
+}
+
+void UItemAssetCache::FailEntry(const FSoftObjectPath& Path)
+{
+    FEntry& Entry = Entries[Path];
+    if (Entry.State == EEntryState::Loading)
+    {
+        --NumLoading;
+    }
+    if (Entry.LoadHandle.IsValid())
+    {
+        Entry.LoadHandle->CancelHandle();
+        Entry.LoadHandle.Reset();
+    }
+    Entry.State = EEntryState::Failed;
+
+    // Waiters still hear about it, their handles simply stay unloaded. A request made after
+    // the last handle is gone tries again.
+    TArray<FSimpleDelegate> Callbacks = MoveTemp(Entry.OnLoaded);
+    Entry.OnLoaded.Reset();
+    for (const FSimpleDelegate& Callback : Callbacks)
+    {
+        Callback.ExecuteIfBound();
+    }
+    StartPendingLoads();
+}
+
+void UItemAssetCache::RemoveEntry(const FSoftObjectPath& Path)
+{
+    FEntry* Entry = Entries.Find(Path);
+    if (!Entry)
+    {
+        return;
+    }
+
+    switch (Entry->State)
+    {
+    case EEntryState::Pending:
+        PendingPaths.RemoveSingle(Path);
+        break;
+
+    case EEntryState::Loading:
+        --NumLoading;
+        break;
+
+    case EEntryState::Resident:
+        ResidentBytes -= Entry->SizeBytes;
+        break;
+
+    case EEntryState::Failed:
+        break;
+    }
+
+    if (Entry->LruNode)
+    {
+        LruList.RemoveNode(Entry->LruNode);
+    }
+
+    // Cancelling also releases a resident asset to the garbage collector
+    if (Entry->LoadHandle.IsValid())
+    {
+        Entry->LoadHandle->CancelHandle();
+    }
+    Entries.Remove(Path);
+}
+
+void UItemAssetCache::EnforceBudget()
+{
+    while (ResidentBytes > BudgetBytes && LruList.GetHead())
+    {
+        const FSoftObjectPath Path = LruList.GetHead()->GetValue();
+        UE_LOG(LogTemp, Verbose, TEXT("ItemAssetCache: evicting %s (%lld bytes resident, budget %lld)"), *Path.ToString(), ResidentBytes, BudgetBytes);
+        RemoveEntry(Path);
+    }
+}
+
+int64 UItemAssetCache::EstimateSize(const UObject* Asset)
+{
+    return Asset ? const_cast<UObject*>(Asset)->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal) : 0;
+}
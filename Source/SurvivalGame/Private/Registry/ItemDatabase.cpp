@@ -0,0 +1,338 @@
+// ItemDatabase.cpp
+
+#include "Registry/ItemDatabase.h"
+#include "Registry/ItemRegistry.h"
+#include "Data/PrimaryData/ItemInfo.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+namespace ItemDatabaseWriter
+{
+    /** Deduplicating UTF-8 string block */
+    struct FStringBlock
+    {
+        TArray<uint8> Bytes;
+        TMap<FString, uint32> Offsets;
+
+        uint32 Add(const FString& Value)
+        {
+            if (const uint32* Existing = Offsets.Find(Value))
+            {
+                return *Existing;
+            }
+
+            const uint32 Offset = static_cast<uint32>(Bytes.Num());
+            const FTCHARToUTF8 Utf8(*Value);
+            Bytes.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+            Bytes.Add(0);
+            Offsets.Add(Value, Offset);
+            return Offset;
+        }
+    };
+
+    template<typename T>
+    void AppendPod(TArray<uint8>& Bytes, const TArray<T>& Values)
+    {
+        Bytes.Append(reinterpret_cast<const uint8*>(Values.GetData()), Values.Num() * sizeof(T));
+    }
+}
+
+FItemDatabase::FItemDatabase() = default;
+
+FItemDatabase::~FItemDatabase()
+{
+    Close();
+}
+
+FString FItemDatabase::GetDefaultPath()
+{
+    return FPaths::ProjectContentDir() / TEXT("ItemDatabase/Items.sgidb");
+}
+
+bool FItemDatabase::Write(const UItemRegistry& Registry, TArray<uint8>& OutBytes)
+{
+    using namespace ItemDatabaseWriter;
+
+    // Index 0 of the handle table is the invalid handle
+    const TArray<FName>& HandleTable = Registry.GetHandleTable();
+    const int32 NumItems = FMath::Max(HandleTable.Num() - 1, 0);
+
+    TArray<FItemDatabaseRecord> Records;
+    TArray<FItemDatabaseModifier> Modifiers;
+    TArray<FItemDatabaseEffect> Effects;
+    TArray<FItemDatabaseTag> Tags;
+    FStringBlock Strings;
+    Records.Reserve(NumItems);
+
+    for (int32 HandleIndex = 1; HandleIndex < HandleTable.Num(); ++HandleIndex)
+    {
+        const FItemHandle Handle(static_cast<uint16>(HandleIndex));
+        const UItemInfo* ItemInfo = Registry.GetItemInfoByHandle(Handle);
+        const FItemStructure* Prototype = Registry.GetItemPrototype(Handle);
+        if (!ItemInfo || !Prototype)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ItemDatabase: handle %d (%s) has no loaded definition"), HandleIndex, *HandleTable[HandleIndex].ToString());
+            return false;
+        }
+
+        // Fields come from the prototype, so the database reproduces exactly what the registry hands out
+        FItemDatabaseRecord& Record = Records.AddZeroed_GetRef();
+        Record.KeyOffset = Strings.Add(HandleTable[HandleIndex].ToString());
+
+        // Stored in exported form so localized names still resolve in the reader's culture
+        FString NameText;
+        FTextStringHelper::WriteToBuffer(NameText, Prototype->ItemName);
+        Record.NameOffset = Strings.Add(NameText);
+
+        Record.MaxStackSize = Prototype->MaxStackSize;
+        Record.MaxDurability = Prototype->MaxDurability;
+        Record.DurabilityDecayRate = Prototype->DurabilityDecayRate;
+        Record.UnitWeight = ItemInfo->UnitWeight;
+        Record.BaseValue = ItemInfo->BaseValue;
+        Record.ItemType = static_cast<uint8>(Prototype->ItemType);
+        Record.ItemCategory = static_cast<uint8>(Prototype->ItemCategory);
+        Record.ItemRarity = static_cast<uint8>(Prototype->ItemRarity);
+        Record.WeightClass = static_cast<uint8>(Prototype->WeightClass);
+        Record.ToolType = static_cast<uint8>(Prototype->ToolType);
+        Record.WeaponType = static_cast<uint8>(Prototype->WeaponType);
+        Record.ArmorType = static_cast<uint8>(Prototype->ArmorType);
+        Record.Flags =
+            (Prototype->bIsStackable ? FItemDatabaseRecord::Stackable : 0) |
+            (Prototype->bIsEquippable ? FItemDatabaseRecord::Equippable : 0) |
+            (Prototype->bHasDurability ? FItemDatabaseRecord::HasDurability : 0) |
+            (ItemInfo->bIsConsumable ? FItemDatabaseRecord::Consumable : 0) |
+            (Prototype->bIsQuestItem ? FItemDatabaseRecord::QuestItem : 0) |
+            (Prototype->bIsUnique ? FItemDatabaseRecord::Unique : 0);
+
+        Record.FirstModifier = static_cast<uint32>(Modifiers.Num());
+        Record.NumModifiers = static_cast<uint16>(FMath::Min(Prototype->DefaultModifiers.Num(), static_cast<int32>(MAX_uint16)));
+        for (int32 i = 0; i < Record.NumModifiers; ++i)
+        {
+            const FItemModifier& Source = Prototype->DefaultModifiers[i];
+            FItemDatabaseModifier& Modifier = Modifiers.AddZeroed_GetRef();
+            Modifier.NameOffset = Strings.Add(Source.ModifierName);
+            Modifier.Value = Source.ModifierValue;
+        }
+
+        Record.FirstEffect = static_cast<uint32>(Effects.Num());
+        Record.NumEffects = static_cast<uint16>(FMath::Min(ItemInfo->ConsumeEffects.Num(), static_cast<int32>(MAX_uint16)));
+        for (int32 i = 0; i < Record.NumEffects; ++i)
+        {
+            const FItemEffectSpec& Source = ItemInfo->ConsumeEffects[i];
+            FItemDatabaseEffect& Effect = Effects.AddZeroed_GetRef();
+            Effect.Magnitude = Source.Magnitude;
+            Effect.Duration = Source.Duration;
+            Effect.MaxStacks = Source.MaxStacks;
+            Effect.Effect = static_cast<uint8>(Source.Effect);
+            Effect.StackPolicy = static_cast<uint8>(Source.StackPolicy);
+        }
+
+        Record.FirstTag = static_cast<uint32>(Tags.Num());
+        Record.NumTags = static_cast<uint16>(FMath::Min(ItemInfo->ItemTags.Num(), static_cast<int32>(MAX_uint16)));
+        for (int32 i = 0; i < Record.NumTags; ++i)
+        {
+            FItemDatabaseTag& Tag = Tags.AddZeroed_GetRef();
+            Tag.NameOffset = Strings.Add(ItemInfo->ItemTags.GetByIndex(i).ToString());
+        }
+    }
+
+    FItemDatabaseHeader Header;
+    FMemory::Memzero(Header);
+    Header.Magic = Magic;
+    Header.Version = FormatVersion;
+    Header.NumItems = static_cast<uint32>(Records.Num());
+    Header.NumModifiers = static_cast<uint32>(Modifiers.Num());
+    Header.NumEffects = static_cast<uint32>(Effects.Num());
+    Header.NumTags = static_cast<uint32>(Tags.Num());
+    Header.StringBytes = static_cast<uint32>(Strings.Bytes.Num());
+    Header.ItemsOffset = sizeof(FItemDatabaseHeader);
+    Header.ModifiersOffset = Header.ItemsOffset + Records.Num() * sizeof(FItemDatabaseRecord);
+    Header.EffectsOffset = Header.ModifiersOffset + Modifiers.Num() * sizeof(FItemDatabaseModifier);
+    Header.TagsOffset = Header.EffectsOffset + Effects.Num() * sizeof(FItemDatabaseEffect);
+    Header.StringsOffset = Header.TagsOffset + Tags.Num() * sizeof(FItemDatabaseTag);
+
+    OutBytes.Reset(Header.StringsOffset + Header.StringBytes);
+    OutBytes.Append(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    AppendPod(OutBytes, Records);
+    AppendPod(OutBytes, Modifiers);
+    AppendPod(OutBytes, Effects);
+    AppendPod(OutBytes, Tags);
+    OutBytes.Append(Strings.Bytes);
+    return true;
+}
+
+bool FItemDatabase::Open(const FString& Path)
+{
+    Close();
+
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    FOpenMappedResult OpenResult = PlatformFile.OpenMappedEx(*Path);
+    if (OpenResult.HasError())
+    {
+        UE_LOG(LogTemp, Log, TEXT("ItemDatabase: %s could not be mapped"), *Path);
+        return false;
+    }
+
+    MappedFile = OpenResult.StealValue();
+    const int64 FileSize = MappedFile->GetFileSize();
+    MappedRegion.Reset(MappedFile->MapRegion(0, FileSize));
+    if (!MappedRegion.IsValid() || FileSize < static_cast<int64>(sizeof(FItemDatabaseHeader)))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemDatabase: %s is empty or could not be mapped"), *Path);
+        Close();
+        return false;
+    }
+
+    const uint8* Base = MappedRegion->GetMappedPtr();
+    Header = reinterpret_cast<const FItemDatabaseHeader*>(Base);
+    Records = reinterpret_cast<const FItemDatabaseRecord*>(Base + Header->ItemsOffset);
+    Modifiers = reinterpret_cast<const FItemDatabaseModifier*>(Base + Header->ModifiersOffset);
+    Effects = reinterpret_cast<const FItemDatabaseEffect*>(Base + Header->EffectsOffset);
+    Tags = reinterpret_cast<const FItemDatabaseTag*>(Base + Header->TagsOffset);
+    Strings = reinterpret_cast<const ANSICHAR*>(Base + Header->StringsOffset);
+
+    // Everything is checked once here, lookups afterwards trust the offsets
+    if (!Validate(FileSize))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemDatabase: %s is corrupt or from another format version"), *Path);
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void FItemDatabase::Close()
+{
+    Header = nullptr;
+    Records = nullptr;
+    Modifiers = nullptr;
+    Effects = nullptr;
+    Tags = nullptr;
+    Strings = nullptr;
+
+    // The region has to go before the file it maps
+    MappedRegion.Reset();
+    MappedFile.Reset();
+}
+
+bool FItemDatabase::Validate(int64 FileSize) const
+{
+    if (Header->Magic != Magic || Header->Version != FormatVersion || Header->NumItems > MAX_uint16)
+    {
+        return false;
+    }
+
+    const auto SectionFits = [FileSize](uint32 Offset, uint64 Count, uint64 Stride)
+    {
+        return Offset % 4 == 0 && static_cast<uint64>(Offset) + Count * Stride <= static_cast<uint64>(FileSize);
+    };
+
+    if (!SectionFits(Header->ItemsOffset, Header->NumItems, sizeof(FItemDatabaseRecord)) ||
+        !SectionFits(Header->ModifiersOffset, Header->NumModifiers, sizeof(FItemDatabaseModifier)) ||
+        !SectionFits(Header->EffectsOffset, Header->NumEffects, sizeof(FItemDatabaseEffect)) ||
+        !SectionFits(Header->TagsOffset, Header->NumTags, sizeof(FItemDatabaseTag)) ||
+        static_cast<uint64>(Header->StringsOffset) + Header->StringBytes > static_cast<uint64>(FileSize) ||
+        Header->StringBytes == 0 || Strings[Header->StringBytes - 1] != '\0')
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < Header->NumItems; ++i)
+    {
+        const FItemDatabaseRecord& Record = Records[i];
+        if (Record.KeyOffset >= Header->StringBytes || Record.NameOffset >= Header->StringBytes ||
+            static_cast<uint64>(Record.FirstModifier) + Record.NumModifiers > Header->NumModifiers ||
+            static_cast<uint64>(Record.FirstEffect) + Record.NumEffects > Header->NumEffects ||
+            static_cast<uint64>(Record.FirstTag) + Record.NumTags > Header->NumTags)
+        {
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < Header->NumModifiers; ++i)
+    {
+        if (Modifiers[i].NameOffset >= Header->StringBytes)
+        {
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < Header->NumTags; ++i)
+    {
+        if (Tags[i].NameOffset >= Header->StringBytes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const ANSICHAR* FItemDatabase::GetString(uint32 Offset) const
+{
+    return Strings + Offset;
+}
+
+FName FItemDatabase::GetKey(const FItemDatabaseRecord& Record) const
+{
+    return FName(UTF8_TO_TCHAR(GetString(Record.KeyOffset)));
+}
+
+TConstArrayView<FItemDatabaseEffect> FItemDatabase::GetEffects(const FItemDatabaseRecord& Record) const
+{
+    return TConstArrayView<FItemDatabaseEffect>(Effects + Record.FirstEffect, Record.NumEffects);
+}
+
+FGameplayTagContainer FItemDatabase::GetTags(const FItemDatabaseRecord& Record) const
+{
+    FGameplayTagContainer ItemTags;
+    for (uint32 i = Record.FirstTag; i < Record.FirstTag + Record.NumTags; ++i)
+    {
+        ItemTags.AddTag(FGameplayTag::RequestGameplayTag(FName(UTF8_TO_TCHAR(GetString(Tags[i].NameOffset))), false));
+    }
+    return ItemTags;
+}
+
+FItemStructure FItemDatabase::MakePrototype(const FItemDatabaseRecord& Record) const
+{
+    FItemStructure NewItem;
+    NewItem.RegistryKey = GetKey(Record);
+    FTextStringHelper::ReadFromBuffer(UTF8_TO_TCHAR(GetString(Record.NameOffset)), NewItem.ItemName);
+    NewItem.ItemType = static_cast<E_ItemType>(Record.ItemType);
+    NewItem.ItemCategory = static_cast<E_ItemCategory>(Record.ItemCategory);
+    NewItem.ItemRarity = static_cast<E_ItemRarity>(Record.ItemRarity);
+
+    NewItem.bIsStackable = Record.HasFlag(FItemDatabaseRecord::Stackable);
+    NewItem.MaxStackSize = Record.MaxStackSize;
+    NewItem.ItemQuantity = 1;
+
+    NewItem.bIsEquippable = Record.HasFlag(FItemDatabaseRecord::Equippable);
+    NewItem.ToolType = static_cast<E_ToolType>(Record.ToolType);
+    NewItem.WeaponType = static_cast<E_WeaponType>(Record.WeaponType);
+    NewItem.ArmorType = static_cast<E_ArmorType>(Record.ArmorType);
+
+    NewItem.bHasDurability = Record.HasFlag(FItemDatabaseRecord::HasDurability);
+    if (NewItem.bHasDurability)
+    {
+        NewItem.CurrentDurability = Record.MaxDurability;
+        NewItem.MaxDurability = Record.MaxDurability;
+        NewItem.DurabilityDecayRate = Record.DurabilityDecayRate;
+    }
+
+    NewItem.WeightClass = static_cast<E_WeightClass>(Record.WeightClass);
+    NewItem.bIsQuestItem = Record.HasFlag(FItemDatabaseRecord::QuestItem);
+    NewItem.bIsUnique = Record.HasFlag(FItemDatabaseRecord::Unique);
+
+    NewItem.DefaultModifiers.Reserve(Record.NumModifiers);
+    for (uint32 i = Record.FirstModifier; i < Record.FirstModifier + Record.NumModifiers; ++i)
+    {
+        FItemModifier& Modifier = NewItem.DefaultModifiers.AddDefaulted_GetRef();
+        Modifier.ModifierName = UTF8_TO_TCHAR(GetString(Modifiers[i].NameOffset));
+        Modifier.ModifierValue = Modifiers[i].Value;
+    }
+    NewItem.ItemModifiers = NewItem.DefaultModifiers;
+
+    NewItem.InitialItemState = E_ItemState::Normal;
+    NewItem.ItemState = E_ItemState::Normal;
+    return NewItem;
+}
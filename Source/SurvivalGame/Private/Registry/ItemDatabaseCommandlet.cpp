@@ -0,0 +1,67 @@
+// ItemDatabaseCommandlet.cpp
+
+#include "Registry/ItemDatabaseCommandlet.h"
+#include "Registry/ItemDatabase.h"
+#include "Registry/ItemManifest.h"
+#include "Registry/ItemRegistry.h"
+#include "Misc/FileHelper.h"
+
+UItemDatabaseCommandlet::UItemDatabaseCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UItemDatabaseCommandlet::Main(const FString& Params)
+{
+    FString OutputPath = FItemDatabase::GetDefaultPath();
+    FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+    UClass* RegistryClass = UItemRegistry::StaticClass();
+    FString RegistryClassPath;
+    if (FParse::Value(*Params, TEXT("Registry="), RegistryClassPath))
+    {
+        RegistryClass = LoadClass<UItemRegistry>(nullptr, *RegistryClassPath);
+        if (!RegistryClass)
+        {
+            UE_LOG(LogTemp, Error, TEXT("ItemDatabase: '%s' is not a UItemRegistry class"), *RegistryClassPath);
+            return 1;
+        }
+    }
+
+    // The registry collects every definition the game would, handles are assigned in the
+    // same order so the database matches what clients build at runtime
+    UItemRegistry* Registry = NewObject<UItemRegistry>(GetTransientPackage(), RegistryClass);
+    Registry->AddToRoot();
+    Registry->Initialize();
+    Registry->WaitUntilInitialized();
+
+    // Records are written from the definitions, which the registry otherwise only loads on request
+    TArray<UItemInfo*> Definitions;
+    Registry->LoadItemInfos(Registry->GetAllRegisteredItemKeys(), Definitions);
+
+    TArray<uint8> Bytes;
+    const bool bWritten = FItemDatabase::Write(*Registry, Bytes);
+
+    // Cooked builds read the manifest instead of enumerating the asset registry
+    const bool bManifestWritten = Registry->BuildManifest().Save(FItemManifest::GetStagedPath());
+    Registry->RemoveFromRoot();
+
+    if (!bWritten)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ItemDatabase: failed to build the database"));
+        return 1;
+    }
+
+    if (!FFileHelper::SaveArrayToFile(Bytes, *OutputPath) || !bManifestWritten)
+    {
+        UE_LOG(LogTemp, Error, TEXT("ItemDatabase: failed to write %s or the item manifest"), *OutputPath);
+        return 1;
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("ItemDatabase: wrote %d items (%d bytes) to %s"),
+        FMath::Max(Registry->GetHandleTable().Num() - 1, 0), Bytes.Num(), *OutputPath);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// ItemDecaySubsystem.cpp
+
+#include "Registry/ItemDecaySubsystem.h"
+#include "Registry/ContainerSubsystem.h"
+#include "Components/Inventory/ItemContainerBase.h"
+#include "GameFramework/GameStateBase.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+double UItemDecaySubsystem::GetDecayTime(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    if (!World)
+    {
+        return 0.0;
+    }
+
+    // Clients follow the replicated server clock, the server reads its own
+    const AGameStateBase* GameState = World->GetGameState();
+    return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void UItemDecaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Decay is authoritative, clients only evaluate it for display
+    if (InWorld.GetNetMode() != NM_Client)
+    {
+        InWorld.GetTimerManager().SetTimer(SweepTimerHandle, this, &UItemDecaySubsystem::Sweep, SweepInterval, true);
+    }
+}
+
+void UItemDecaySubsystem::Deinitialize()
+{
+    if (UWorld* World = GetWorld())
+    {
+        World->GetTimerManager().ClearTimer(SweepTimerHandle);
+    }
+
+    Super::Deinitialize();
+}
+
+void UItemDecaySubsystem::Sweep()
+{
+    const UContainerSubsystem* Containers = UContainerSubsystem::Get(this);
+    if (!Containers)
+    {
+        return;
+    }
+
+    const TConstArrayView<TObjectPtr<UItemContainerBase>> AllContainers = Containers->GetAllContainers();
+    const int32 NumContainers = AllContainers.Num();
+    if (NumContainers == 0)
+    {
+        return;
+    }
+
+    // Take the slice first, event handlers may destroy containers and reshuffle the registry
+    TArray<TWeakObjectPtr<UItemContainerBase>, TInlineAllocator<ContainersPerSweep>> Slice;
+    const int32 NumToVisit = FMath::Min(ContainersPerSweep, NumContainers);
+    for (int32 Visited = 0; Visited < NumToVisit; ++Visited)
+    {
+        SweepCursor = SweepCursor < NumContainers ? SweepCursor : 0;
+        Slice.Add(AllContainers[SweepCursor++].Get());
+    }
+
+    // Containers that have nothing expiring return immediately, so a slice is cheap
+    const double Now = GetDecayTime(this);
+    for (const TWeakObjectPtr<UItemContainerBase>& Container : Slice)
+    {
+        if (Container.IsValid())
+        {
+            Container->ProcessDecay(Now);
+        }
+    }
+}
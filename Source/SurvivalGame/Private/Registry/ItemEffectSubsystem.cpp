@@ -0,0 +1,191 @@
+// ItemEffectSubsystem.cpp
+
+#include "Registry/ItemEffectSubsystem.h"
+#include "Data/PrimaryData/ItemInfo.h"
+#include "Engine/World.h"
+
+UItemEffectSubsystem::UItemEffectSubsystem()
+    : Wheel(WheelTickSeconds)
+{
+}
+
+UItemEffectSubsystem* UItemEffectSubsystem::Get(const UObject* WorldContextObject)
+{
+    const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+    return World ? World->GetSubsystem<UItemEffectSubsystem>() : nullptr;
+}
+
+void UItemEffectSubsystem::Deinitialize()
+{
+    ActiveEffects.Empty();
+    EffectLookup.Empty();
+    Wheel = FHierarchicalTimerWheel(WheelTickSeconds);
+
+    Super::Deinitialize();
+}
+
+bool UItemEffectSubsystem::IsTickable() const
+{
+    // Nothing to advance while no timed effect is active
+    return Super::IsTickable() && Wheel.Num() > 0;
+}
+
+TStatId UItemEffectSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UItemEffectSubsystem, STATGROUP_Tickables);
+}
+
+void UItemEffectSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    ExpiredPayloads.Reset();
+    Wheel.Advance(DeltaTime, ExpiredPayloads);
+    if (ExpiredPayloads.Num() == 0)
+    {
+        return;
+    }
+
+    // Retire the whole batch before broadcasting, so handlers that apply or remove
+    // effects cannot be confused with entries still waiting in the batch
+    TArray<FActiveEffect, TInlineAllocator<16>> Expired;
+    for (const uint64 Payload : ExpiredPayloads)
+    {
+        const int32 EffectIndex = static_cast<int32>(Payload);
+        if (ActiveEffects.IsValidIndex(EffectIndex))
+        {
+            Expired.Add(ActiveEffects[EffectIndex]);
+            RemoveEffectAt(EffectIndex);
+        }
+    }
+
+    for (const FActiveEffect& Effect : Expired)
+    {
+        if (AActor* Target = Effect.Target.Get())
+        {
+            OnItemEffectExpired.Broadcast(Target, Effect.Effect);
+        }
+    }
+}
+
+void UItemEffectSubsystem::ApplyItemEffects(AActor* Target, const UItemInfo* ItemInfo)
+{
+    if (ItemInfo)
+    {
+        ApplyEffects(Target, ItemInfo->ConsumeEffects);
+    }
+}
+
+void UItemEffectSubsystem::ApplyEffects(AActor* Target, TConstArrayView<FItemEffectSpec> Specs)
+{
+    for (const FItemEffectSpec& Spec : Specs)
+    {
+        ApplyEffect(Target, Spec);
+    }
+}
+
+void UItemEffectSubsystem::ApplyEffect(AActor* Target, const FItemEffectSpec& Spec)
+{
+    if (!Target || Spec.Effect == E_ItemEffect::None)
+    {
+        return;
+    }
+
+    // Restores and other instant effects have nothing to expire
+    if (Spec.Duration <= 0.0f)
+    {
+        OnItemEffectApplied.Broadcast(Target, Spec.Effect, Spec.Magnitude, 1);
+        return;
+    }
+
+    const FEffectKey Key(Target, Spec.Effect);
+    if (const int32* ExistingIndex = EffectLookup.Find(Key))
+    {
+        FActiveEffect& Active = ActiveEffects[*ExistingIndex];
+        double Duration = Spec.Duration;
+
+        switch (Spec.StackPolicy)
+        {
+            case E_EffectStackPolicy::Stack:
+                Active.Stacks = FMath::Min(Active.Stacks + 1, FMath::Max(Spec.MaxStacks, 1));
+                Active.Magnitude = Spec.Magnitude;
+                break;
+            case E_EffectStackPolicy::Extend:
+                Duration += Wheel.GetRemainingSeconds(Active.TimerId);
+                Active.Magnitude = FMath::Max(Active.Magnitude, Spec.Magnitude);
+                break;
+            default:
+                Active.Magnitude = FMath::Max(Active.Magnitude, Spec.Magnitude);
+                break;
+        }
+
+        Wheel.Cancel(Active.TimerId);
+        Active.TimerId = Wheel.Schedule(Duration, static_cast<uint64>(*ExistingIndex));
+        OnItemEffectApplied.Broadcast(Target, Active.Effect, Active.Magnitude * Active.Stacks, Active.Stacks);
+        return;
+    }
+
+    const int32 EffectIndex = ActiveEffects.Add(FActiveEffect());
+    FActiveEffect& Active = ActiveEffects[EffectIndex];
+    Active.Target = Target;
+    Active.TargetKey = Target;
+    Active.Effect = Spec.Effect;
+    Active.Magnitude = Spec.Magnitude;
+    Active.Stacks = 1;
+    Active.TimerId = Wheel.Schedule(Spec.Duration, static_cast<uint64>(EffectIndex));
+    EffectLookup.Add(Key, EffectIndex);
+
+    OnItemEffectApplied.Broadcast(Target, Active.Effect, Active.Magnitude, Active.Stacks);
+}
+
+bool UItemEffectSubsystem::RemoveEffect(AActor* Target, E_ItemEffect Effect)
+{
+    const int32* EffectIndex = EffectLookup.Find(FEffectKey(Target, Effect));
+    if (!EffectIndex)
+    {
+        return false;
+    }
+
+    const int32 IndexToRemove = *EffectIndex;
+    Wheel.Cancel(ActiveEffects[IndexToRemove].TimerId);
+    RemoveEffectAt(IndexToRemove);
+    return true;
+}
+
+void UItemEffectSubsystem::RemoveAllEffects(AActor* Target)
+{
+    const TObjectKey<AActor> TargetKey(Target);
+    TArray<int32, TInlineAllocator<8>> ToRemove;
+    for (auto It = ActiveEffects.CreateConstIterator(); It; ++It)
+    {
+        if (It->TargetKey == TargetKey)
+        {
+            ToRemove.Add(It.GetIndex());
+        }
+    }
+
+    for (const int32 EffectIndex : ToRemove)
+    {
+        Wheel.Cancel(ActiveEffects[EffectIndex].TimerId);
+        RemoveEffectAt(EffectIndex);
+    }
+}
+
+float UItemEffectSubsystem::GetEffectMagnitude(const AActor* Target, E_ItemEffect Effect) const
+{
+    const int32* EffectIndex = EffectLookup.Find(FEffectKey(Target, Effect));
+    return EffectIndex ? ActiveEffects[*EffectIndex].Magnitude * ActiveEffects[*EffectIndex].Stacks : 0.0f;
+}
+
+float UItemEffectSubsystem::GetEffectRemainingTime(const AActor* Target, E_ItemEffect Effect) const
+{
+    const int32* EffectIndex = EffectLookup.Find(FEffectKey(Target, Effect));
+    return EffectIndex ? static_cast<float>(Wheel.GetRemainingSeconds(ActiveEffects[*EffectIndex].TimerId)) : 0.0f;
+}
+
+void UItemEffectSubsystem::RemoveEffectAt(int32 EffectIndex)
+{
+    const FActiveEffect& Effect = ActiveEffects[EffectIndex];
+    EffectLookup.Remove(FEffectKey(Effect.TargetKey, Effect.Effect));
+    ActiveEffects.RemoveAt(EffectIndex);
+}
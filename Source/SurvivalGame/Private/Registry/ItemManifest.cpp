@@ -0,0 +1,278 @@
+// ItemManifest.cpp
+
+#include "Registry/ItemManifest.h"
+#include "Data/PrimaryData/ItemInfo.h"
+#include "Data/Struct/ItemStructure.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    template<typename EnumType>
+    bool ParseEnumTag(const FAssetData& AssetData, FName Tag, EnumType& OutValue)
+    {
+        FString ValueString;
+        if (!AssetData.GetTagValue(Tag, ValueString))
+        {
+            return false;
+        }
+
+        // Accepts both "Value" and "EnumType::Value"
+        const int64 Value = StaticEnum<EnumType>()->GetValueByNameString(ValueString);
+        if (Value == INDEX_NONE)
+        {
+            return false;
+        }
+
+        OutValue = static_cast<EnumType>(Value);
+        return true;
+    }
+
+    template<typename ValueType>
+    bool ParseNumericTag(const FAssetData& AssetData, FName Tag, ValueType& OutValue)
+    {
+        FString ValueString;
+        if (!AssetData.GetTagValue(Tag, ValueString) || !ValueString.IsNumeric())
+        {
+            return false;
+        }
+
+        LexFromString(OutValue, *ValueString);
+        return true;
+    }
+
+    /** Reverse of FGameplayTagContainer::ToStringSimple, tags unknown to this build are dropped */
+    FGameplayTagContainer ParseTags(const FString& TagsString)
+    {
+        TArray<FString> TagNames;
+        TagsString.ParseIntoArray(TagNames, TEXT(","));
+
+        FGameplayTagContainer Tags;
+        for (FString& TagName : TagNames)
+        {
+            TagName.TrimStartAndEndInline();
+            const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName(*TagName), false);
+            UE_CLOG(!Tag.IsValid(), LogTemp, Warning, TEXT("ItemManifest: unknown gameplay tag %s"), *TagName);
+            Tags.AddTag(Tag);
+        }
+        return Tags;
+    }
+}
+
+bool FItemManifestEntry::FromAssetData(const FAssetData& AssetData, FItemManifestEntry& OutEntry)
+{
+    FString RegistryKeyString;
+    FString ItemTagsString;
+    FString IconPathString;
+    if (!AssetData.GetTagValue(UItemInfo::RegistryKeyTag, RegistryKeyString) ||
+        !AssetData.GetTagValue(UItemInfo::ItemTagsTag, ItemTagsString) ||
+        !AssetData.GetTagValue(UItemInfo::PrototypeTag, OutEntry.PrototypeText) ||
+        !ParseEnumTag(AssetData, GET_MEMBER_NAME_CHECKED(UItemInfo, ItemType), OutEntry.ItemType) ||
+        !ParseEnumTag(AssetData, GET_MEMBER_NAME_CHECKED(UItemInfo, ItemCategory), OutEntry.ItemCategory) ||
+        !ParseEnumTag(AssetData, GET_MEMBER_NAME_CHECKED(UItemInfo, ItemRarity), OutEntry.ItemRarity) ||
+        !ParseNumericTag(AssetData, GET_MEMBER_NAME_CHECKED(UItemInfo, UnitWeight), OutEntry.UnitWeight) ||
+        !ParseNumericTag(AssetData, GET_MEMBER_NAME_CHECKED(UItemInfo, BaseValue), OutEntry.BaseValue))
+    {
+        return false;
+    }
+
+    OutEntry.RegistryKey = FName(*RegistryKeyString);
+    OutEntry.AssetPath = AssetData.GetSoftObjectPath();
+    OutEntry.ItemTags = ParseTags(ItemTagsString);
+
+    // Items without an icon may have the tag dropped along with its empty value
+    if (AssetData.GetTagValue(UItemInfo::ItemIconTag, IconPathString))
+    {
+        OutEntry.IconPath.SetPath(IconPathString);
+    }
+    return true;
+}
+
+FItemManifestEntry FItemManifestEntry::FromItemInfo(const UItemInfo& ItemInfo)
+{
+    FItemManifestEntry Entry;
+    Entry.RegistryKey = ItemInfo.GetRegistryKey();
+    Entry.ItemType = ItemInfo.ItemType;
+    Entry.ItemCategory = ItemInfo.ItemCategory;
+    Entry.ItemRarity = ItemInfo.ItemRarity;
+    Entry.ItemTags = ItemInfo.ItemTags;
+    Entry.IconPath = ItemInfo.ItemIcon.ToSoftObjectPath();
+    Entry.UnitWeight = ItemInfo.UnitWeight;
+    Entry.BaseValue = ItemInfo.BaseValue;
+    Entry.PrototypeText = ExportPrototype(ItemInfo.BuildPrototype());
+
+    // Items created at runtime have no asset to come back to
+    if (ItemInfo.IsAsset())
+    {
+        Entry.AssetPath = FSoftObjectPath(&ItemInfo);
+    }
+    return Entry;
+}
+
+FString FItemManifestEntry::ExportPrototype(const FItemStructure& Prototype)
+{
+    const FItemStructure Defaults;
+    FString Text;
+    FItemStructure::StaticStruct()->ExportText(Text, &Prototype, &Defaults, nullptr, PPF_None, nullptr);
+    return Text;
+}
+
+bool FItemManifestEntry::ImportPrototype(FItemStructure& OutPrototype) const
+{
+    if (PrototypeText.IsEmpty())
+    {
+        return false;
+    }
+
+    FItemStructure Prototype;
+    FStringOutputDevice Errors;
+    if (!FItemStructure::StaticStruct()->ImportText(*PrototypeText, &Prototype, nullptr, PPF_None, &Errors, FItemStructure::StaticStruct()->GetName()) ||
+        !Errors.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemManifest: prototype of %s does not parse: %s"), *RegistryKey.ToString(), *Errors);
+        return false;
+    }
+
+    OutPrototype = MoveTemp(Prototype);
+    return true;
+}
+
+FArchive& operator<<(FArchive& Ar, FItemManifestEntry& Entry)
+{
+    FString RegistryKey = Entry.RegistryKey.ToString();
+    FString AssetPath = Entry.AssetPath.ToString();
+    uint8 ItemType = static_cast<uint8>(Entry.ItemType);
+    uint8 ItemCategory = static_cast<uint8>(Entry.ItemCategory);
+    uint8 ItemRarity = static_cast<uint8>(Entry.ItemRarity);
+    FString ItemTags = Entry.ItemTags.ToStringSimple();
+    FString IconPath = Entry.IconPath.ToString();
+
+    Ar << RegistryKey << AssetPath << ItemType << ItemCategory << ItemRarity << ItemTags << IconPath;
+    Ar << Entry.UnitWeight << Entry.BaseValue << Entry.PrototypeText;
+
+    if (Ar.IsLoading())
+    {
+        Entry.RegistryKey = FName(*RegistryKey);
+        Entry.AssetPath.SetPath(AssetPath);
+        Entry.ItemType = static_cast<E_ItemType>(ItemType);
+        Entry.ItemCategory = static_cast<E_ItemCategory>(ItemCategory);
+        Entry.ItemRarity = static_cast<E_ItemRarity>(ItemRarity);
+        Entry.ItemTags = ParseTags(ItemTags);
+        Entry.IconPath.SetPath(IconPath);
+    }
+    return Ar;
+}
+
+FString FItemManifest::GetStagedPath()
+{
+    return FPaths::ProjectContentDir() / TEXT("ItemDatabase/ItemManifest.bin");
+}
+
+FString FItemManifest::GetCachePath()
+{
+    return FPaths::ProjectSavedDir() / TEXT("ItemRegistry/ItemManifest.bin");
+}
+
+FItemManifest FItemManifest::Gather(bool bScanPaths)
+{
+    IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+    if (bScanPaths)
+    {
+        // Same directories the asset manager scans for the item primary asset type
+        TArray<FString> ScanPaths;
+        FPrimaryAssetTypeInfo TypeInfo;
+        UAssetManager* AssetManager = UAssetManager::GetIfInitialized();
+        if (AssetManager && AssetManager->GetPrimaryAssetTypeInfo(UItemInfo::PrimaryAssetType, TypeInfo))
+        {
+            ScanPaths = TypeInfo.AssetScanPaths;
+        }
+        if (ScanPaths.Num() == 0)
+        {
+            ScanPaths.Add(TEXT("/Game"));
+        }
+        AssetRegistry.ScanPathsSynchronous(ScanPaths);
+    }
+
+    FARFilter Filter;
+    Filter.ClassPaths.Add(UItemInfo::StaticClass()->GetClassPathName());
+    Filter.bRecursiveClasses = true;
+
+    TArray<FAssetData> AssetDataList;
+    AssetRegistry.GetAssets(Filter, AssetDataList);
+
+    FItemManifest Manifest;
+    Manifest.Entries.Reserve(AssetDataList.Num());
+    int32 NumUntagged = 0;
+    for (const FAssetData& AssetData : AssetDataList)
+    {
+        FItemManifestEntry Entry;
+        if (!FItemManifestEntry::FromAssetData(AssetData, Entry))
+        {
+            const UItemInfo* ItemInfo = Cast<UItemInfo>(AssetData.GetAsset());
+            if (!ItemInfo)
+            {
+                continue;
+            }
+            Entry = FItemManifestEntry::FromItemInfo(*ItemInfo);
+            ++NumUntagged;
+        }
+        Manifest.Entries.Add(MoveTemp(Entry));
+    }
+
+    UE_CLOG(NumUntagged > 0, LogTemp, Warning, TEXT("ItemManifest: %d item assets have no registry tags and had to be loaded, resave them"), NumUntagged);
+
+    Manifest.Entries.Sort([](const FItemManifestEntry& A, const FItemManifestEntry& B)
+    {
+        return A.RegistryKey.LexicalLess(B.RegistryKey);
+    });
+    return Manifest;
+}
+
+bool FItemManifest::Load(const FString& Path)
+{
+    TArray<uint8> Bytes;
+    if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Reader(Bytes);
+    uint32 FileMagic = 0;
+    uint32 FileVersion = 0;
+    Reader << FileMagic << FileVersion;
+    if (FileMagic != Magic || FileVersion != FormatVersion)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemManifest: %s has an unknown format, ignoring it"), *Path);
+        return false;
+    }
+
+    Reader << Entries;
+    if (Reader.IsError())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemManifest: %s is truncated, ignoring it"), *Path);
+        Entries.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FItemManifest::Save(const FString& Path) const
+{
+    TArray<uint8> Bytes;
+    FMemoryWriter Writer(Bytes);
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = FormatVersion;
+    Writer << FileMagic << FileVersion;
+    Writer << const_cast<TArray<FItemManifestEntry>&>(Entries);
+
+    if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ItemManifest: failed to write %s"), *Path);
+        return false;
+    }
+    return true;
+}
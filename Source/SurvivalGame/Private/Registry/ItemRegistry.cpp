@@ -2,27 +2,131 @@
 
 #include "SurvivalGame/Public/Registry/ItemRegistry.h"
 #include "Engine/AssetManager.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Internationalization/Internationalization.h"
+#include "Misc/CommandLine.h"
+#include "Engine/PackageMapClient.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Core/SurvivalGameInstance.h"
+#include "Core/SurvivalPlayerController.h"
 
 UItemRegistry::UItemRegistry()
     : bIsInitialized(false)
 {
 }
 
+void UItemRegistry::BeginDestroy()
+{
+    if (DefaultItemsHandle.IsValid())
+    {
+        DefaultItemsHandle->CancelHandle();
+        DefaultItemsHandle.Reset();
+    }
+
+    for (const TSharedPtr<FStreamableHandle>& Request : BlueprintItemRequests)
+    {
+        Request->CancelHandle();
+    }
+    BlueprintItemRequests.Reset();
+
+    Database.Close();
+
+    if (AssetRegistryFilesLoadedHandle.IsValid())
+    {
+        if (IAssetRegistry* AssetRegistry = IAssetRegistry::Get())
+        {
+            AssetRegistry->OnFilesLoaded().Remove(AssetRegistryFilesLoadedHandle);
+        }
+        AssetRegistryFilesLoadedHandle.Reset();
+    }
+
+    if (CultureChangedHandle.IsValid())
+    {
+        FInternationalization::Get().OnCultureChanged().Remove(CultureChangedHandle);
+        CultureChangedHandle.Reset();
+    }
+
+    Super::BeginDestroy();
+}
+
+UItemRegistry* UItemRegistry::GetForPackageMap(UPackageMap* Map)
+{
+    UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+    UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+    UNetDriver* Driver = Connection ? Connection->GetDriver() : nullptr;
+    USurvivalGameInstance* GameInstance = Driver ? USurvivalGameInstance::Get(Driver->GetWorld()) : nullptr;
+    return GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+}
+
+bool UItemRegistry::IsHandleVerified(UPackageMap* Map, FItemHandle Handle)
+{
+    // The player controller of the connection holds the result of the login handshake,
+    // connections without one (replays) always fall back to keys
+    UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+    const UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+    const ASurvivalPlayerController* PlayerController = Connection ? Cast<ASurvivalPlayerController>(Connection->PlayerController) : nullptr;
+    return PlayerController && Handle.IsValid() && Handle.GetIndex() < PlayerController->GetNumVerifiedItemHandles();
+}
+
 void UItemRegistry::Initialize()
 {
-    if (bIsInitialized)
+    if (bIsInitialized || bIsLoading)
     {
         return;
     }
 
     // Clear any existing registrations
     RegisteredItems.Empty();
+    KnownItems.Empty();
+    ResetIndices();
+    TagIndex.Reset();
+    ItemsByHandle.Reset();
+    KeysByHandle.Reset();
+    PrototypesByHandle.Reset();
+    HandlesByKey.Reset();
+    CatalogChecksums.Reset();
+
+    // Name order depends on the active culture's collation rules
+    CultureChangedHandle = FInternationalization::Get().OnCultureChanged().AddUObject(this, &UItemRegistry::InvalidateNameSortRanks);
 
-    // Load default items
+    LoadStartTime = FPlatformTime::Seconds();
+
+    if (ShouldUseItemDatabase() && InitializeFromDatabase())
+    {
+        return;
+    }
+
+    // Every item is known up front, definitions load on first use
+    DiscoverItems();
+
+    // Load default items the manifest missed, finishes initialization when the last one is registered
     LoadDefaultItems();
+}
 
-    bIsInitialized = true;
-    OnItemRegistryInitialized.Broadcast();
+void UItemRegistry::WaitUntilInitialized()
+{
+    if (bIsLoading && DefaultItemsHandle.IsValid())
+    {
+        DefaultItemsHandle->WaitUntilComplete();
+    }
+
+    // The completion delegate may still be queued for the next tick
+    if (bIsLoading)
+    {
+        HandleDefaultItemsLoaded();
+    }
+}
+
+void UItemRegistry::CallOrRegister_OnInitialized(FSimpleDelegate&& Callback)
+{
+    if (bIsInitialized)
+    {
+        Callback.ExecuteIfBound();
+        return;
+    }
+
+    OnInitializedNative.Add(MoveTemp(Callback));
 }
 
 bool UItemRegistry::RegisterItem(UItemInfo* ItemInfo)
@@ -35,91 +139,946 @@ bool UItemRegistry::RegisterItem(UItemInfo* ItemInfo)
     const FName RegistryKey = ItemInfo->GetRegistryKey();
 
     // Check if item is already registered
-    if (RegisteredItems.Contains(RegistryKey))
+    if (KnownItems.Contains(RegistryKey))
     {
         UE_LOG(LogTemp, Warning, TEXT("Item with registry key %s is already registered!"), *RegistryKey.ToString());
         return false;
     }
 
-    // Register the item
+    // Register the item, already loaded
     RegisteredItems.Add(RegistryKey, ItemInfo);
 
+    return AddKnownItem(FItemManifestEntry::FromItemInfo(*ItemInfo));
+}
+
+bool UItemRegistry::AddKnownItem(const FItemManifestEntry& Entry)
+{
+    // Same checks ValidateItemInfo makes, the rest waits until the definition loads
+    if (Entry.ItemType == E_ItemType::None || Entry.ItemCategory == E_ItemCategory::None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Item %s has an invalid type or category!"), *Entry.RegistryKey.ToString());
+        return false;
+    }
+
+    if (KnownItems.Contains(Entry.RegistryKey))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Item with registry key %s is already registered!"), *Entry.RegistryKey.ToString());
+        return false;
+    }
+
+    KnownItems.Add(Entry.RegistryKey, Entry);
+    AddToIndices(Entry);
+
+    // Late registrations are appended, items known at startup are numbered together at the end of loading
+    if (bIsInitialized)
+    {
+        AssignHandle(Entry.RegistryKey);
+    }
+
     // Broadcast event
-    OnItemRegistered.Broadcast(RegistryKey);
+    OnItemRegistered.Broadcast(Entry.RegistryKey);
 
     return true;
 }
 
+UItemInfo* UItemRegistry::LoadItemInfo(FName RegistryKey)
+{
+    if (UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
+    {
+        return ItemInfo;
+    }
+
+    const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+    if (!Entry || Entry->AssetPath.IsNull())
+    {
+        return nullptr;
+    }
+
+    const double LoadStart = FPlatformTime::Seconds();
+    UItemInfo* ItemInfo = AddLoadedItemInfo(RegistryKey, Entry->AssetPath.TryLoad());
+
+    UE_CLOG(ItemInfo, LogTemp, Verbose, TEXT("ItemRegistry: loaded %s synchronously in %.1f ms"),
+        *RegistryKey.ToString(), (FPlatformTime::Seconds() - LoadStart) * 1000.0);
+    return ItemInfo;
+}
+
+void UItemRegistry::LoadItemInfos(TConstArrayView<FName> RegistryKeys, TArray<UItemInfo*>& OutItems)
+{
+    // Request everything missing in one batch, so packages are read together instead of one by one
+    TArray<FSoftObjectPath> PathsToLoad;
+    for (const FName& RegistryKey : RegistryKeys)
+    {
+        const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+        if (Entry && !Entry->AssetPath.IsNull() && !RegisteredItems.Contains(RegistryKey))
+        {
+            PathsToLoad.Add(Entry->AssetPath);
+        }
+    }
+    if (PathsToLoad.Num() > 1)
+    {
+        UAssetManager::GetStreamableManager().RequestSyncLoad(PathsToLoad);
+    }
+
+    OutItems.Reserve(OutItems.Num() + RegistryKeys.Num());
+    for (const FName& RegistryKey : RegistryKeys)
+    {
+        if (UItemInfo* ItemInfo = LoadItemInfo(RegistryKey))
+        {
+            OutItems.Add(ItemInfo);
+        }
+    }
+}
+
+TSharedPtr<FStreamableHandle> UItemRegistry::RequestItemInfos(TConstArrayView<FName> RegistryKeys, FSimpleDelegate OnLoaded, TAsyncLoadPriority Priority)
+{
+    TArray<FName> KeysToLoad;
+    TArray<FSoftObjectPath> PathsToLoad;
+    for (const FName& RegistryKey : RegistryKeys)
+    {
+        const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+        if (Entry && !Entry->AssetPath.IsNull() && !RegisteredItems.Contains(RegistryKey) && !KeysToLoad.Contains(RegistryKey))
+        {
+            KeysToLoad.Add(RegistryKey);
+            PathsToLoad.Add(Entry->AssetPath);
+        }
+    }
+
+    if (PathsToLoad.Num() == 0)
+    {
+        OnLoaded.ExecuteIfBound();
+        return nullptr;
+    }
+
+    // Whichever request finishes first registers a shared definition, the others find it registered
+    TWeakObjectPtr<UItemRegistry> WeakThis(this);
+    return UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(PathsToLoad),
+        FStreamableDelegate::CreateLambda([WeakThis, KeysToLoad = MoveTemp(KeysToLoad), OnLoaded = MoveTemp(OnLoaded)]()
+        {
+            UItemRegistry* Registry = WeakThis.Get();
+            if (!Registry)
+            {
+                return;
+            }
+
+            for (const FName& RegistryKey : KeysToLoad)
+            {
+                const FItemManifestEntry* Entry = Registry->KnownItems.Find(RegistryKey);
+                if (Entry && !Entry->AssetPath.IsNull() && !Registry->RegisteredItems.Contains(RegistryKey))
+                {
+                    Registry->AddLoadedItemInfo(RegistryKey, Entry->AssetPath.ResolveObject());
+                }
+            }
+            OnLoaded.ExecuteIfBound();
+        }),
+        Priority);
+}
+
+void UItemRegistry::LoadItemInfoAsync(FName RegistryKey, const FOnItemInfoLoaded& OnLoaded)
+{
+    TWeakObjectPtr<UItemRegistry> WeakThis(this);
+    TSharedPtr<FStreamableHandle> Request = RequestItemInfos(MakeArrayView(&RegistryKey, 1),
+        FSimpleDelegate::CreateLambda([WeakThis, RegistryKey, OnLoaded]()
+        {
+            if (UItemRegistry* Registry = WeakThis.Get())
+            {
+                OnLoaded.ExecuteIfBound(Registry->GetItemInfo(RegistryKey));
+            }
+        }));
+
+    // Finished requests are dropped here rather than from the callback, which may run before we get the handle
+    BlueprintItemRequests.RemoveAll([](const TSharedPtr<FStreamableHandle>& Pending)
+    {
+        return !Pending->IsLoadingInProgress();
+    });
+    if (Request.IsValid() && Request->IsLoadingInProgress())
+    {
+        BlueprintItemRequests.Add(MoveTemp(Request));
+    }
+}
+
+UItemInfo* UItemRegistry::AddLoadedItemInfo(FName RegistryKey, UObject* LoadedObject)
+{
+    FItemManifestEntry& Entry = KnownItems.FindChecked(RegistryKey);
+    UItemInfo* ItemInfo = Cast<UItemInfo>(LoadedObject);
+    if (!ItemInfo || ItemInfo->GetRegistryKey() != RegistryKey || !ValidateItemInfo(ItemInfo))
+    {
+        // A stale manifest entry or a broken asset, don't try again on every lookup
+        UE_LOG(LogTemp, Warning, TEXT("Failed to load item %s from %s"), *RegistryKey.ToString(), *Entry.AssetPath.ToString());
+        Entry.AssetPath.Reset();
+        return nullptr;
+    }
+
+    // Name ranks cover every known item already, a load does not move them
+    RegisteredItems.Add(RegistryKey, ItemInfo);
+    if (const FItemHandle* Handle = HandlesByKey.Find(RegistryKey))
+    {
+        ItemsByHandle[Handle->GetIndex()] = ItemInfo;
+    }
+    return ItemInfo;
+}
+
 FItemStructure UItemRegistry::CreateItemInstance(const FName& RegistryKey, int32 Quantity) const
 {
+    const FItemHandle Handle = FindItemHandle(RegistryKey);
+    if (Handle.IsValid())
+    {
+        return CreateItemInstanceFromHandle(Handle, Quantity);
+    }
+
+    // Not numbered yet (still loading), build it the slow way
     if (UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
     {
         return ItemInfo->CreateItemInstance(Quantity);
     }
 
+    FItemStructure NewItem;
+    const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+    if (Entry && Entry->ImportPrototype(NewItem))
+    {
+        NewItem.ItemQuantity = FMath::Clamp(Quantity, 1, NewItem.bIsStackable ? NewItem.MaxStackSize : 1);
+        return NewItem;
+    }
+
     // Return empty item structure if item not found
     return FItemStructure();
 }
 
+FItemStructure UItemRegistry::CreateItemInstanceFromHandle(FItemHandle Handle, int32 Quantity) const
+{
+    if (const FItemStructure* Prototype = GetItemPrototype(Handle))
+    {
+        FItemStructure NewItem = *Prototype;
+        NewItem.ItemQuantity = FMath::Clamp(Quantity, 1, NewItem.bIsStackable ? NewItem.MaxStackSize : 1);
+        return NewItem;
+    }
+
+    return FItemStructure();
+}
+
+int32 UItemRegistry::CreateItemInstances(FItemHandle Handle, const TArray<int32>& Quantities, TArray<FItemStructure>& OutItems) const
+{
+    const FItemStructure* Prototype = GetItemPrototype(Handle);
+    if (!Prototype)
+    {
+        return 0;
+    }
+
+    const int32 StackLimit = Prototype->bIsStackable ? FMath::Max(Prototype->MaxStackSize, 1) : 1;
+
+    int32 NumInstances = 0;
+    for (const int32 Quantity : Quantities)
+    {
+        NumInstances += Quantity > 0 ? FMath::DivideAndRoundUp(Quantity, StackLimit) : 0;
+    }
+    OutItems.Reserve(OutItems.Num() + NumInstances);
+
+    for (const int32 Quantity : Quantities)
+    {
+        for (int32 Remaining = Quantity; Remaining > 0; Remaining -= StackLimit)
+        {
+            FItemStructure& NewItem = OutItems.Add_GetRef(*Prototype);
+            NewItem.ItemQuantity = FMath::Min(Remaining, StackLimit);
+        }
+    }
+    return NumInstances;
+}
+
+const FItemStructure* UItemRegistry::GetItemPrototype(FItemHandle Handle) const
+{
+    if (!Handle.IsValid() || !PrototypesByHandle.IsValidIndex(Handle.GetIndex()))
+    {
+        return nullptr;
+    }
+
+    // Nothing is loaded here, this runs while decoding replicated items. Database entries are
+    // built once at startup, manifest entries from their exported prototype on first use.
+    FItemPrototype& Prototype = PrototypesByHandle[Handle.GetIndex()];
+    const UItemInfo* ItemInfo = GetItemInfoByHandle(Handle);
+    if (!ItemInfo)
+    {
+        if (!Prototype.bIsBuilt)
+        {
+            const FItemManifestEntry* Entry = KnownItems.Find(KeysByHandle[Handle.GetIndex()]);
+            if (!Entry || !Entry->ImportPrototype(Prototype.Item))
+            {
+                return nullptr;
+            }
+            Prototype.Item.ItemHandle = Handle;
+            Prototype.bIsBuilt = true;
+        }
+        return &Prototype.Item;
+    }
+
+    if (!Prototype.bFromDefinition || Prototype.DefinitionVersion != ItemInfo->GetDefinitionVersion())
+    {
+        Prototype.Item = ItemInfo->BuildPrototype();
+        Prototype.Item.ItemHandle = Handle;
+        Prototype.DefinitionVersion = ItemInfo->GetDefinitionVersion();
+        Prototype.bIsBuilt = true;
+        Prototype.bFromDefinition = true;
+    }
+    return &Prototype.Item;
+}
+
+FItemHandle UItemRegistry::FindItemHandle(const FName& RegistryKey) const
+{
+    const FItemHandle* Handle = HandlesByKey.Find(RegistryKey);
+    return Handle ? *Handle : FItemHandle();
+}
+
+FName UItemRegistry::GetItemKey(FItemHandle Handle) const
+{
+    return KeysByHandle.IsValidIndex(Handle.GetIndex()) ? KeysByHandle[Handle.GetIndex()] : NAME_None;
+}
+
+TArray<FItemHandle> UItemRegistry::BuildHandleRemap(TConstArrayView<FName> SavedHandleTable) const
+{
+    TArray<FItemHandle> Remap;
+    Remap.SetNum(SavedHandleTable.Num());
+    for (int32 SavedIndex = 1; SavedIndex < SavedHandleTable.Num(); ++SavedIndex)
+    {
+        Remap[SavedIndex] = FindItemHandle(SavedHandleTable[SavedIndex]);
+    }
+    return Remap;
+}
+
+void UItemRegistry::AssignHandle(FName RegistryKey)
+{
+    if (ItemsByHandle.Num() == 0)
+    {
+        // Slot 0 is the invalid handle
+        ItemsByHandle.Add(nullptr);
+        KeysByHandle.Add(NAME_None);
+        PrototypesByHandle.AddDefaulted();
+        CatalogChecksums.Add(0);
+    }
+
+    if (ItemsByHandle.Num() > MAX_uint16)
+    {
+        UE_LOG(LogTemp, Error, TEXT("Item handle space exhausted, %s has no handle"), *RegistryKey.ToString());
+        return;
+    }
+
+    // Null until the definition is loaded
+    const FItemHandle Handle(static_cast<uint16>(ItemsByHandle.Num()));
+    ItemsByHandle.Add(RegisteredItems.FindRef(RegistryKey));
+    KeysByHandle.Add(RegistryKey);
+    PrototypesByHandle.AddDefaulted();
+    HandlesByKey.Add(RegistryKey, Handle);
+    AppendCatalogChecksum(RegistryKey);
+
+    // Names of unloaded items come from their prototypes, which need a handle
+    InvalidateNameSortRanks();
+
+    if (const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey))
+    {
+        TagIndex.Add(Handle.GetIndex(), Entry->ItemTags);
+    }
+}
+
+void UItemRegistry::AssignPendingHandles()
+{
+    TArray<FName> PendingKeys;
+    PendingKeys.Reserve(KnownItems.Num());
+    for (const auto& Pair : KnownItems)
+    {
+        if (!HandlesByKey.Contains(Pair.Key))
+        {
+            PendingKeys.Add(Pair.Key);
+        }
+    }
+
+    // Lexical order is independent of load order and of FName table layout
+    PendingKeys.Sort([](const FName& A, const FName& B) { return A.LexicalLess(B); });
+
+    ItemsByHandle.Reserve(ItemsByHandle.Num() + PendingKeys.Num() + 1);
+    KeysByHandle.Reserve(KeysByHandle.Num() + PendingKeys.Num() + 1);
+    PrototypesByHandle.Reserve(PrototypesByHandle.Num() + PendingKeys.Num() + 1);
+    CatalogChecksums.Reserve(CatalogChecksums.Num() + PendingKeys.Num() + 1);
+    HandlesByKey.Reserve(HandlesByKey.Num() + PendingKeys.Num());
+    for (const FName& RegistryKey : PendingKeys)
+    {
+        AssignHandle(RegistryKey);
+    }
+}
+
+void UItemRegistry::AppendCatalogChecksum(FName RegistryKey)
+{
+    // Lowercase, FName comparison ignores case and either casing may be the first one a process sees
+    const uint32 Previous = CatalogChecksums.Num() > 0 ? CatalogChecksums.Last() : 0;
+    CatalogChecksums.Add(FCrc::StrCrc32(*RegistryKey.ToString().ToLower(), Previous));
+}
+
+uint32 UItemRegistry::GetCatalogChecksum(int32 NumHandles) const
+{
+    return NumHandles > 0 && CatalogChecksums.IsValidIndex(NumHandles - 1) ? CatalogChecksums[NumHandles - 1] : 0;
+}
+
+float UItemRegistry::GetItemUnitWeight(const FName& RegistryKey) const
+{
+    // A loaded definition wins, it may have been edited since the manifest was gathered
+    if (const UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
+    {
+        return ItemInfo->UnitWeight;
+    }
+
+    const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+    return Entry ? Entry->UnitWeight : 0.0f;
+}
+
+int32 UItemRegistry::GetItemBaseValue(const FName& RegistryKey) const
+{
+    if (const UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
+    {
+        return ItemInfo->BaseValue;
+    }
+
+    const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+    return Entry ? Entry->BaseValue : 0;
+}
+
+float UItemRegistry::GetUnitWeightByHandle(FItemHandle Handle) const
+{
+    return GetItemUnitWeight(GetItemKey(Handle));
+}
+
+int32 UItemRegistry::GetBaseValueByHandle(FItemHandle Handle) const
+{
+    return GetItemBaseValue(GetItemKey(Handle));
+}
+
+bool UItemRegistry::GetConsumeEffects(FItemHandle Handle, TArray<FItemEffectSpec>& OutEffects)
+{
+    OutEffects.Reset();
+
+    const UItemInfo* ItemInfo = GetItemInfoByHandle(Handle);
+    if (!ItemInfo && !Database.IsOpen())
+    {
+        ItemInfo = LoadItemInfo(GetItemKey(Handle));
+    }
+
+    if (ItemInfo)
+    {
+        if (!ItemInfo->bIsConsumable)
+        {
+            return false;
+        }
+        OutEffects = ItemInfo->ConsumeEffects;
+        return true;
+    }
+
+    const FItemDatabaseRecord* Record = Database.FindRecord(Handle);
+    if (!Record || !Record->HasFlag(FItemDatabaseRecord::Consumable))
+    {
+        return false;
+    }
+
+    for (const FItemDatabaseEffect& Source : Database.GetEffects(*Record))
+    {
+        FItemEffectSpec& Effect = OutEffects.AddDefaulted_GetRef();
+        Effect.Effect = static_cast<E_ItemEffect>(Source.Effect);
+        Effect.Magnitude = Source.Magnitude;
+        Effect.Duration = Source.Duration;
+        Effect.StackPolicy = static_cast<E_EffectStackPolicy>(Source.StackPolicy);
+        Effect.MaxStacks = Source.MaxStacks;
+    }
+    return true;
+}
+
+FText UItemRegistry::GetItemDisplayName(const FName& RegistryKey) const
+{
+    if (const UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
+    {
+        return ItemInfo->ItemName;
+    }
+
+    const FItemStructure* Prototype = GetItemPrototype(FindItemHandle(RegistryKey));
+    return Prototype ? Prototype->ItemName : FText::GetEmpty();
+}
+
+FSoftObjectPath UItemRegistry::GetItemIconPath(const FName& RegistryKey) const
+{
+    if (const UItemInfo* ItemInfo = GetItemInfo(RegistryKey))
+    {
+        return ItemInfo->GetAssetPath(E_ItemAssetKind::Icon);
+    }
+
+    const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+    return Entry ? Entry->IconPath : FSoftObjectPath();
+}
+
+int32 UItemRegistry::GetItemNameSortRank(const FName& RegistryKey) const
+{
+    if (!bNameSortRanksValid)
+    {
+        RebuildNameSortRanks();
+    }
+
+    const int32* Rank = NameSortRanks.Find(RegistryKey);
+    return Rank ? *Rank : MAX_int32;
+}
+
+void UItemRegistry::RebuildNameSortRanks() const
+{
+    TArray<TPair<FName, FText>> SortedItems;
+    SortedItems.Reserve(KnownItems.Num());
+    for (const auto& Pair : KnownItems)
+    {
+        SortedItems.Emplace(Pair.Key, GetItemDisplayName(Pair.Key));
+    }
+
+    // Locale-aware comparison happens once here, sorting containers only compares ranks
+    SortedItems.Sort([](const TPair<FName, FText>& A, const TPair<FName, FText>& B)
+    {
+        const int32 Compare = A.Value.CompareTo(B.Value);
+        return Compare != 0 ? Compare < 0 : A.Key.LexicalLess(B.Key);
+    });
+
+    NameSortRanks.Reset();
+    NameSortRanks.Reserve(SortedItems.Num());
+    for (int32 Rank = 0; Rank < SortedItems.Num(); ++Rank)
+    {
+        NameSortRanks.Add(SortedItems[Rank].Key, Rank);
+    }
+    bNameSortRanksValid = true;
+}
+
+void UItemRegistry::InvalidateNameSortRanks()
+{
+    bNameSortRanksValid = false;
+}
+
 TArray<FName> UItemRegistry::GetAllRegisteredItemKeys() const
 {
     TArray<FName> Keys;
-    RegisteredItems.GetKeys(Keys);
+    KnownItems.GetKeys(Keys);
     return Keys;
 }
 
-TArray<UItemInfo*> UItemRegistry::GetItemsByType(E_ItemType ItemType) const
+TArray<UItemInfo*> UItemRegistry::GetItemsByType(E_ItemType ItemType)
+{
+    TArray<UItemInfo*> Items;
+    LoadItemInfos(ViewItemKeysByType(ItemType), Items);
+    return Items;
+}
+
+TArray<UItemInfo*> UItemRegistry::GetItemsByCategory(E_ItemCategory ItemCategory)
 {
     TArray<UItemInfo*> Items;
-    
-    for (const auto& Pair : RegisteredItems)
+    LoadItemInfos(ViewItemKeysByCategory(ItemCategory), Items);
+    return Items;
+}
+
+TArray<UItemInfo*> UItemRegistry::GetItemsByRarity(E_ItemRarity ItemRarity)
+{
+    TArray<UItemInfo*> Items;
+    LoadItemInfos(ViewItemKeysByRarity(ItemRarity), Items);
+    return Items;
+}
+
+int32 UItemRegistry::QueryItems(const FItemQueryFilter& Filter, TArray<UItemInfo*>& OutItems)
+{
+    TArray<FName> Keys;
+    QueryItemKeys(Filter, Keys);
+
+    const int32 StartNum = OutItems.Num();
+    LoadItemInfos(Keys, OutItems);
+    return OutItems.Num() - StartNum;
+}
+
+int32 UItemRegistry::QueryItemKeys(const FItemQueryFilter& Filter, TArray<FName>& OutKeys) const
+{
+    const bool bFilterType = Filter.ItemType != E_ItemType::None;
+    const bool bFilterCategory = Filter.ItemCategory != E_ItemCategory::None;
+    const bool bFilterRarity = Filter.ItemRarity != E_ItemRarity::None;
+    const auto MatchesFields = [&](E_ItemType ItemType, E_ItemCategory ItemCategory, E_ItemRarity ItemRarity)
     {
-        if (Pair.Value && Pair.Value->ItemType == ItemType)
+        return (!bFilterType || ItemType == Filter.ItemType) &&
+            (!bFilterCategory || ItemCategory == Filter.ItemCategory) &&
+            (!bFilterRarity || ItemRarity == Filter.ItemRarity);
+    };
+
+    const int32 StartNum = OutKeys.Num();
+    if (!Filter.TagQuery.IsEmpty())
+    {
+        // The tag index narrows the whole catalog in a few word-wise passes, the enum fields
+        // are checked on what is left
+        TBitArray<> TagMatches;
+        QueryItemHandlesByTags(Filter.TagQuery, TagMatches);
+        for (TConstSetBitIterator<> It(TagMatches); It; ++It)
         {
-            Items.Add(Pair.Value);
+            const FName RegistryKey = KeysByHandle[It.GetIndex()];
+            const FItemManifestEntry* Entry = KnownItems.Find(RegistryKey);
+            if (Entry && MatchesFields(Entry->ItemType, Entry->ItemCategory, Entry->ItemRarity))
+            {
+                OutKeys.Add(RegistryKey);
+            }
         }
+        return OutKeys.Num() - StartNum;
     }
-    
-    return Items;
+
+    // Start from the smallest bucket, every other filter only has to reject from it
+    TConstArrayView<FName> Candidates;
+    bool bHasCandidates = false;
+    const auto ConsiderBucket = [&Candidates, &bHasCandidates](TConstArrayView<FName> Bucket)
+    {
+        if (!bHasCandidates || Bucket.Num() < Candidates.Num())
+        {
+            Candidates = Bucket;
+            bHasCandidates = true;
+        }
+    };
+
+    if (bFilterType)
+    {
+        ConsiderBucket(ViewItemKeysByType(Filter.ItemType));
+    }
+    if (bFilterCategory)
+    {
+        ConsiderBucket(ViewItemKeysByCategory(Filter.ItemCategory));
+    }
+    if (bFilterRarity)
+    {
+        ConsiderBucket(ViewItemKeysByRarity(Filter.ItemRarity));
+    }
+
+    if (!bHasCandidates)
+    {
+        // No filter at all, every item matches
+        OutKeys.Reserve(StartNum + KnownItems.Num());
+        for (const auto& Pair : KnownItems)
+        {
+            OutKeys.Add(Pair.Key);
+        }
+        return OutKeys.Num() - StartNum;
+    }
+
+    for (const FName& RegistryKey : Candidates)
+    {
+        const FItemManifestEntry& Entry = KnownItems.FindChecked(RegistryKey);
+        if (MatchesFields(Entry.ItemType, Entry.ItemCategory, Entry.ItemRarity))
+        {
+            OutKeys.Add(RegistryKey);
+        }
+    }
+    return OutKeys.Num() - StartNum;
 }
 
-TArray<UItemInfo*> UItemRegistry::GetItemsByCategory(E_ItemCategory ItemCategory) const
+void UItemRegistry::QueryItemHandlesByTags(const FGameplayTagQuery& Query, TBitArray<>& OutMatches) const
 {
-    TArray<UItemInfo*> Items;
-    
-    for (const auto& Pair : RegisteredItems)
+    TagIndex.Evaluate(Query, ItemsByHandle.Num(), OutMatches);
+
+    // Negated queries set the bit of the invalid handle too
+    if (OutMatches.Num() > 0)
+    {
+        OutMatches[0] = false;
+    }
+}
+
+int32 UItemRegistry::QueryItemKeysByTags(const FGameplayTagQuery& Query, TArray<FName>& OutKeys) const
+{
+    FItemQueryFilter Filter;
+    Filter.TagQuery = Query;
+    return QueryItemKeys(Filter, OutKeys);
+}
+
+int32 UItemRegistry::QueryItemsByTags(const FGameplayTagQuery& Query, TArray<UItemInfo*>& OutItems)
+{
+    FItemQueryFilter Filter;
+    Filter.TagQuery = Query;
+    return QueryItems(Filter, OutItems);
+}
+
+bool UItemRegistry::ItemHasTag(FItemHandle Handle, FGameplayTag Tag) const
+{
+    const TBitArray<>* Items = TagIndex.FindItems(Tag);
+    return Items && Handle.IsValid() && Items->IsValidIndex(Handle.GetIndex()) && (*Items)[Handle.GetIndex()];
+}
+
+FItemManifest UItemRegistry::BuildManifest() const
+{
+    FItemManifest Manifest;
+    Manifest.Entries.Reserve(KnownItems.Num());
+    for (const auto& Pair : KnownItems)
     {
-        if (Pair.Value && Pair.Value->ItemCategory == ItemCategory)
+        if (!Pair.Value.AssetPath.IsNull())
         {
-            Items.Add(Pair.Value);
+            Manifest.Entries.Add(Pair.Value);
         }
     }
-    
-    return Items;
+
+    Manifest.Entries.Sort([](const FItemManifestEntry& A, const FItemManifestEntry& B)
+    {
+        return A.RegistryKey.LexicalLess(B.RegistryKey);
+    });
+    return Manifest;
+}
+
+void UItemRegistry::AddToIndices(const FItemManifestEntry& Entry)
+{
+    const FName RegistryKey = Entry.RegistryKey;
+    const auto AddToBucket = [RegistryKey](TArray<TArray<FName>>& Buckets, uint8 Index)
+    {
+        if (Index >= Buckets.Num())
+        {
+            Buckets.SetNum(Index + 1);
+        }
+        Buckets[Index].Add(RegistryKey);
+    };
+
+    AddToBucket(KeysByType, static_cast<uint8>(Entry.ItemType));
+    AddToBucket(KeysByCategory, static_cast<uint8>(Entry.ItemCategory));
+    AddToBucket(KeysByRarity, static_cast<uint8>(Entry.ItemRarity));
+}
+
+void UItemRegistry::ResetIndices()
+{
+    KeysByType.Reset();
+    KeysByCategory.Reset();
+    KeysByRarity.Reset();
+}
+
+bool UItemRegistry::ShouldUseItemDatabase() const
+{
+    return IsRunningDedicatedServer() && !FParse::Param(FCommandLine::Get(), TEXT("NoItemDatabase"));
+}
+
+bool UItemRegistry::InitializeFromDatabase()
+{
+    FString Path = FItemDatabase::GetDefaultPath();
+    FParse::Value(FCommandLine::Get(), TEXT("ItemDatabase="), Path);
+    if (!Database.Open(Path))
+    {
+        UE_LOG(LogTemp, Log, TEXT("ItemRegistry: no usable item database at %s, loading item definitions"), *Path);
+        return false;
+    }
+
+    // Records are stored in handle order, handle N is record N - 1
+    const int32 NumItems = Database.Num();
+    ItemsByHandle.Init(nullptr, NumItems + 1);
+    KeysByHandle.Reset(NumItems + 1);
+    KeysByHandle.Add(NAME_None);
+    PrototypesByHandle.SetNum(NumItems + 1);
+    HandlesByKey.Reserve(NumItems);
+    KnownItems.Reserve(NumItems);
+    CatalogChecksums.Reset(NumItems + 1);
+    CatalogChecksums.Add(0);
+
+    for (int32 HandleIndex = 1; HandleIndex <= NumItems; ++HandleIndex)
+    {
+        const FItemHandle Handle(static_cast<uint16>(HandleIndex));
+        const FItemDatabaseRecord& Record = *Database.FindRecord(Handle);
+
+        FItemPrototype& Prototype = PrototypesByHandle[HandleIndex];
+        Prototype.Item = Database.MakePrototype(Record);
+        Prototype.Item.ItemHandle = Handle;
+        Prototype.bIsBuilt = true;
+
+        KeysByHandle.Add(Prototype.Item.RegistryKey);
+        HandlesByKey.Add(Prototype.Item.RegistryKey, Handle);
+        AppendCatalogChecksum(Prototype.Item.RegistryKey);
+
+        // Known and bucketed like a manifest entry, without an asset to load
+        FItemManifestEntry Entry;
+        Entry.RegistryKey = Prototype.Item.RegistryKey;
+        Entry.ItemType = static_cast<E_ItemType>(Record.ItemType);
+        Entry.ItemCategory = static_cast<E_ItemCategory>(Record.ItemCategory);
+        Entry.ItemRarity = static_cast<E_ItemRarity>(Record.ItemRarity);
+        Entry.ItemTags = Database.GetTags(Record);
+        Entry.UnitWeight = Record.UnitWeight;
+        Entry.BaseValue = Record.BaseValue;
+        TagIndex.Add(HandleIndex, Entry.ItemTags);
+        AddToIndices(Entry);
+        KnownItems.Add(Entry.RegistryKey, MoveTemp(Entry));
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("ItemRegistry: mapped %d items from %s in %.1f ms"),
+        NumItems, *Path, (FPlatformTime::Seconds() - LoadStartTime) * 1000.0);
+
+    FinishInitialization();
+    return true;
+}
+
+void UItemRegistry::DiscoverItems()
+{
+    const double DiscoveryStart = FPlatformTime::Seconds();
+
+    FItemManifest Manifest;
+    const TCHAR* Source = TEXT("asset registry");
+    if (FPlatformProperties::RequiresCookedData())
+    {
+        // Staged by UItemDatabaseCommandlet, the cooked asset registry is already in memory otherwise
+        if (Manifest.Load(FItemManifest::GetStagedPath()))
+        {
+            Source = TEXT("staged manifest");
+        }
+        else
+        {
+            Manifest = FItemManifest::Gather(false);
+        }
+    }
+    else if (IAssetRegistry::GetChecked().IsLoadingAssets() && Manifest.Load(FItemManifest::GetCachePath()))
+    {
+        // The editor is still scanning, start from the last result and pick up changes once it is done
+        Source = TEXT("cached manifest");
+        AssetRegistryFilesLoadedHandle = IAssetRegistry::GetChecked().OnFilesLoaded().AddUObject(this, &UItemRegistry::HandleAssetRegistryFilesLoaded);
+    }
+    else
+    {
+        Manifest = FItemManifest::Gather(true);
+        Manifest.Save(FItemManifest::GetCachePath());
+    }
+
+    KnownItems.Reserve(Manifest.Entries.Num());
+    for (const FItemManifestEntry& Entry : Manifest.Entries)
+    {
+        AddKnownItem(Entry);
+    }
+
+    DiscoveryTime = FPlatformTime::Seconds() - DiscoveryStart;
+    UE_LOG(LogTemp, Log, TEXT("ItemRegistry: discovered %d items from the %s in %.1f ms"),
+        KnownItems.Num(), Source, DiscoveryTime * 1000.0);
+}
+
+void UItemRegistry::HandleAssetRegistryFilesLoaded()
+{
+    IAssetRegistry::GetChecked().OnFilesLoaded().Remove(AssetRegistryFilesLoadedHandle);
+    AssetRegistryFilesLoadedHandle.Reset();
+
+    // Items added since the cache was written are appended, removed ones fail on their first load
+    const FItemManifest Manifest = FItemManifest::Gather(false);
+    int32 NumAdded = 0;
+    for (const FItemManifestEntry& Entry : Manifest.Entries)
+    {
+        if (!KnownItems.Contains(Entry.RegistryKey) && AddKnownItem(Entry))
+        {
+            ++NumAdded;
+        }
+    }
+    Manifest.Save(FItemManifest::GetCachePath());
+
+    UE_CLOG(NumAdded > 0, LogTemp, Log, TEXT("ItemRegistry: %d items added since the cached manifest was written"), NumAdded);
 }
 
 void UItemRegistry::LoadDefaultItems()
 {
-    // Create a streamable manager for async loading
-    FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+    RegisterTime = 0.0;
 
-    // Load all default items
+    TSet<FSoftObjectPath> DiscoveredPaths;
+    DiscoveredPaths.Reserve(KnownItems.Num());
+    for (const auto& Pair : KnownItems)
+    {
+        DiscoveredPaths.Add(Pair.Value.AssetPath);
+    }
+
+    PendingDefaultItems.Reset(DefaultItems.Num());
+    PendingDefaultItemsCursor = 0;
     for (const auto& ItemPtr : DefaultItems)
     {
-        if (!ItemPtr.IsNull())
+        if (!ItemPtr.IsNull() && !DiscoveredPaths.Contains(ItemPtr.ToSoftObjectPath()))
         {
-            // Load the item synchronously
-            UItemInfo* LoadedItem = ItemPtr.LoadSynchronous();
-            if (LoadedItem)
-            {
-                RegisterItem(LoadedItem);
-            }
-            else
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Failed to load default item %s"), *ItemPtr.ToString());
-            }
+            PendingDefaultItems.Add(ItemPtr.ToSoftObjectPath());
+        }
+    }
+
+    if (PendingDefaultItems.Num() == 0)
+    {
+        FinishInitialization();
+        return;
+    }
+
+    // One batched request, the streamer overlaps IO and serialization across all items
+    bIsLoading = true;
+    const double RequestStart = FPlatformTime::Seconds();
+    FStreamableManager& StreamableManager = UAssetManager::GetStreamableManager();
+    TSharedPtr<FStreamableHandle> Handle = StreamableManager.RequestAsyncLoad(PendingDefaultItems,
+        FStreamableDelegate::CreateUObject(this, &UItemRegistry::HandleDefaultItemsLoaded),
+        FStreamableManager::AsyncLoadHighPriority);
+    LoadRequestTime = FPlatformTime::Seconds() - RequestStart;
+
+    // Everything was already in memory and the completion delegate ran inside the request
+    if (!bIsLoading)
+    {
+        return;
+    }
+
+    if (Handle.IsValid())
+    {
+        DefaultItemsHandle = Handle;
+        DefaultItemsHandle->BindUpdateDelegate(FStreamableUpdateDelegate::CreateUObject(this, &UItemRegistry::HandleDefaultItemsProgress));
+    }
+    else
+    {
+        // No handle means nothing could be requested, register whatever is already in memory
+        HandleDefaultItemsLoaded();
+    }
+}
+
+void UItemRegistry::HandleDefaultItemsProgress(TSharedRef<FStreamableHandle> Handle)
+{
+    RegisterLoadedDefaultItems(false);
+}
+
+void UItemRegistry::HandleDefaultItemsLoaded()
+{
+    if (!bIsLoading)
+    {
+        return;
+    }
+
+    RegisterLoadedDefaultItems(true);
+    FinishInitialization();
+}
+
+void UItemRegistry::RegisterLoadedDefaultItems(bool bFinal)
+{
+    const double RegisterStart = FPlatformTime::Seconds();
+
+    // Packages mostly complete in request order, so the cursor usually advances one item per
+    // update. Anything that finished out of order is picked up by the final pass.
+    while (PendingDefaultItemsCursor < PendingDefaultItems.Num())
+    {
+        const FSoftObjectPath& Path = PendingDefaultItems[PendingDefaultItemsCursor];
+        UItemInfo* LoadedItem = Cast<UItemInfo>(Path.ResolveObject());
+        if (!LoadedItem && !bFinal)
+        {
+            break;
         }
+
+        if (LoadedItem)
+        {
+            RegisterItem(LoadedItem);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to load default item %s"), *Path.ToString());
+        }
+        ++PendingDefaultItemsCursor;
     }
+
+    RegisterTime += FPlatformTime::Seconds() - RegisterStart;
+}
+
+void UItemRegistry::FinishInitialization()
+{
+    const double TotalTime = FPlatformTime::Seconds() - LoadStartTime;
+    UE_CLOG(!Database.IsOpen(), LogTemp, Log, TEXT("ItemRegistry: %d items known, %d loaded (%d default items outside the manifest) in %.1f ms (discovery %.1f ms, request %.1f ms, streaming %.1f ms, register %.1f ms)"),
+        KnownItems.Num(), RegisteredItems.Num(), PendingDefaultItems.Num(), TotalTime * 1000.0, DiscoveryTime * 1000.0,
+        LoadRequestTime * 1000.0, FMath::Max(TotalTime - DiscoveryTime - LoadRequestTime - RegisterTime, 0.0) * 1000.0, RegisterTime * 1000.0);
+
+    // Registered items are referenced by RegisteredItems, the handle is no longer needed
+    bIsLoading = false;
+    DefaultItemsHandle.Reset();
+    PendingDefaultItems.Empty();
+    PendingDefaultItemsCursor = 0;
+
+    AssignPendingHandles();
+
+    bIsInitialized = true;
+    FSimpleMulticastDelegate Callbacks = MoveTemp(OnInitializedNative);
+    OnInitializedNative.Clear();
+    Callbacks.Broadcast();
+    OnItemRegistryInitialized.Broadcast();
 }
 
 bool UItemRegistry::ValidateItemInfo(const UItemInfo* ItemInfo) const
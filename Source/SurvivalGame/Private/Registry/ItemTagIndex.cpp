@@ -0,0 +1,140 @@
+// ItemTagIndex.cpp
+
+#include "Registry/ItemTagIndex.h"
+
+namespace
+{
+    void SetItemBit(TBitArray<>& Bits, int32 ItemIndex)
+    {
+        if (Bits.Num() <= ItemIndex)
+        {
+            Bits.PadToNum(ItemIndex + 1, false);
+        }
+        Bits[ItemIndex] = true;
+    }
+}
+
+void FItemTagIndex::Reset()
+{
+    ItemsByTag.Reset();
+    ItemsByExactTag.Reset();
+}
+
+void FItemTagIndex::Add(int32 ItemIndex, const FGameplayTagContainer& Tags)
+{
+    for (const FGameplayTag& Tag : Tags)
+    {
+        SetItemBit(ItemsByExactTag.FindOrAdd(Tag), ItemIndex);
+    }
+
+    for (const FGameplayTag& Tag : Tags.GetGameplayTagParents())
+    {
+        SetItemBit(ItemsByTag.FindOrAdd(Tag), ItemIndex);
+    }
+}
+
+void FItemTagIndex::Evaluate(const FGameplayTagQuery& Query, int32 NumItems, TBitArray<>& OutMatches) const
+{
+    if (Query.IsEmpty())
+    {
+        OutMatches.Init(false, NumItems);
+        return;
+    }
+
+    FGameplayTagQueryExpression Expr;
+    Query.GetQueryExpr(Expr);
+    EvaluateExpr(Expr, NumItems, OutMatches);
+}
+
+void FItemTagIndex::EvaluateExpr(const FGameplayTagQueryExpression& Expr, int32 NumItems, TBitArray<>& OutMatches) const
+{
+    // Empty sets follow FGameplayTagQuery: "any" matches nothing, "all" and "no" match everything
+    switch (Expr.ExprType)
+    {
+    case EGameplayTagQueryExprType::AnyTagsMatch:
+        MatchAnyTag(Expr.TagSet, false, NumItems, OutMatches);
+        break;
+
+    case EGameplayTagQueryExprType::AnyTagsExactMatch:
+        MatchAnyTag(Expr.TagSet, true, NumItems, OutMatches);
+        break;
+
+    case EGameplayTagQueryExprType::AllTagsMatch:
+        MatchAllTags(Expr.TagSet, false, NumItems, OutMatches);
+        break;
+
+    case EGameplayTagQueryExprType::AllTagsExactMatch:
+        MatchAllTags(Expr.TagSet, true, NumItems, OutMatches);
+        break;
+
+    case EGameplayTagQueryExprType::NoTagsMatch:
+        MatchAnyTag(Expr.TagSet, false, NumItems, OutMatches);
+        OutMatches.BitwiseNOT();
+        break;
+
+    case EGameplayTagQueryExprType::AnyExprMatch:
+    case EGameplayTagQueryExprType::NoExprMatch:
+    {
+        OutMatches.Init(false, NumItems);
+        TBitArray<> SubMatches;
+        for (const FGameplayTagQueryExpression& SubExpr : Expr.ExprSet)
+        {
+            EvaluateExpr(SubExpr, NumItems, SubMatches);
+            OutMatches.CombineWithBitwiseOR(SubMatches, EBitwiseOperatorFlags::MaintainSize);
+        }
+        if (Expr.ExprType == EGameplayTagQueryExprType::NoExprMatch)
+        {
+            OutMatches.BitwiseNOT();
+        }
+        break;
+    }
+
+    case EGameplayTagQueryExprType::AllExprMatch:
+    {
+        OutMatches.Init(true, NumItems);
+        TBitArray<> SubMatches;
+        for (const FGameplayTagQueryExpression& SubExpr : Expr.ExprSet)
+        {
+            EvaluateExpr(SubExpr, NumItems, SubMatches);
+            OutMatches.CombineWithBitwiseAND(SubMatches, EBitwiseOperatorFlags::MaintainSize);
+        }
+        break;
+    }
+
+    default:
+        OutMatches.Init(false, NumItems);
+        break;
+    }
+}
+
+void FItemTagIndex::MatchAnyTag(TConstArrayView<FGameplayTag> Tags, bool bExact, int32 NumItems, TBitArray<>& OutMatches) const
+{
+    const TMap<FGameplayTag, TBitArray<>>& Index = bExact ? ItemsByExactTag : ItemsByTag;
+
+    OutMatches.Init(false, NumItems);
+    for (const FGameplayTag& Tag : Tags)
+    {
+        if (const TBitArray<>* Items = Index.Find(Tag))
+        {
+            OutMatches.CombineWithBitwiseOR(*Items, EBitwiseOperatorFlags::MaintainSize);
+        }
+    }
+}
+
+void FItemTagIndex::MatchAllTags(TConstArrayView<FGameplayTag> Tags, bool bExact, int32 NumItems, TBitArray<>& OutMatches) const
+{
+    const TMap<FGameplayTag, TBitArray<>>& Index = bExact ? ItemsByExactTag : ItemsByTag;
+
+    OutMatches.Init(true, NumItems);
+    for (const FGameplayTag& Tag : Tags)
+    {
+        const TBitArray<>* Items = Index.Find(Tag);
+        if (!Items)
+        {
+            // Nobody carries this tag, so nobody carries all of them
+            OutMatches.Init(false, NumItems);
+            return;
+        }
+        OutMatches.CombineWithBitwiseAND(*Items, EBitwiseOperatorFlags::MaintainSize);
+    }
+}
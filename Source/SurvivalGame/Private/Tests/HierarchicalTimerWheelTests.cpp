@@ -0,0 +1,143 @@
+// HierarchicalTimerWheelTests.cpp
+
+#include "Core/HierarchicalTimerWheel.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HierarchicalTimerWheelTests
+{
+    /** One-second ticks, so delays and advances below are counted in ticks */
+    constexpr double TickSeconds = 1.0;
+
+    /** Ticks covered by the four levels of 64 slots, beyond that timers go around again */
+    constexpr uint64 WheelRangeTicks = uint64(1) << 24;
+
+    /** Schedule a timer DelayTicks out after the clock already moved by OffsetTicks, and check it fires on exactly that tick */
+    bool TestFiresOnTick(FAutomationTestBase& Test, uint64 OffsetTicks, uint64 DelayTicks)
+    {
+        FHierarchicalTimerWheel Wheel(TickSeconds);
+        TArray<uint64> Expired;
+        Wheel.Advance(static_cast<double>(OffsetTicks), Expired);
+
+        const uint64 Payload = 42;
+        Wheel.Schedule(static_cast<double>(DelayTicks), Payload);
+
+        Wheel.Advance(static_cast<double>(DelayTicks - 1), Expired);
+        const FString Context = FString::Printf(TEXT("offset %llu, delay %llu"), OffsetTicks, DelayTicks);
+        if (!Test.TestEqual(*FString::Printf(TEXT("Nothing fires before the last tick (%s)"), *Context), Expired.Num(), 0))
+        {
+            return false;
+        }
+
+        Wheel.Advance(TickSeconds, Expired);
+        return Test.TestEqual(*FString::Printf(TEXT("Fires on its tick (%s)"), *Context), Expired.Num(), 1) &&
+               Test.TestEqual(*FString::Printf(TEXT("Payload (%s)"), *Context), Expired[0], Payload) &&
+               Test.TestEqual(*FString::Printf(TEXT("Wheel empty afterwards (%s)"), *Context), Wheel.Num(), 0);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHierarchicalTimerWheelCascadeTest, "SurvivalGame.Core.HierarchicalTimerWheel.Cascade",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHierarchicalTimerWheelCascadeTest::RunTest(const FString& Parameters)
+{
+    using namespace HierarchicalTimerWheelTests;
+
+    // Level boundaries, either side of them, and with the clock not aligned to a level
+    const uint64 Delays[] = { 1, 63, 64, 65, 127, 128, 4095, 4096, 4097, 64 * 4096 };
+    const uint64 Offsets[] = { 0, 37, 4000 };
+    for (const uint64 Offset : Offsets)
+    {
+        for (const uint64 Delay : Delays)
+        {
+            TestFiresOnTick(*this, Offset, Delay);
+        }
+    }
+
+    // Timers in different levels come out in expiry order
+    FHierarchicalTimerWheel Wheel(TickSeconds);
+    Wheel.Schedule(4096.0, 3);
+    Wheel.Schedule(64.0, 2);
+    Wheel.Schedule(5.0, 1);
+
+    TArray<uint64> Expired;
+    Wheel.Advance(4096.0, Expired);
+    TestEqual(TEXT("Every timer fired"), Expired.Num(), 3);
+    if (Expired.Num() == 3)
+    {
+        TestEqual(TEXT("First"), Expired[0], uint64(1));
+        TestEqual(TEXT("Second"), Expired[1], uint64(2));
+        TestEqual(TEXT("Third"), Expired[2], uint64(3));
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHierarchicalTimerWheelCancelTest, "SurvivalGame.Core.HierarchicalTimerWheel.CancelAfterReschedule",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHierarchicalTimerWheelCancelTest::RunTest(const FString& Parameters)
+{
+    using namespace HierarchicalTimerWheelTests;
+
+    FHierarchicalTimerWheel Wheel(TickSeconds);
+    TArray<uint64> Expired;
+
+    // Cancel and reschedule, the new timer reuses the node under a new generation
+    FWheelTimerId TimerId = Wheel.Schedule(10.0, 1);
+    const FWheelTimerId StaleId = TimerId;
+    TestTrue(TEXT("Cancel a pending timer"), Wheel.Cancel(TimerId));
+    TestFalse(TEXT("Cancel invalidates the caller's ID"), TimerId.IsValid());
+
+    FWheelTimerId RescheduledId = Wheel.Schedule(20.0, 2);
+    TestEqual(TEXT("Node is reused"), RescheduledId.Index, StaleId.Index);
+    TestNotEqual(TEXT("Generation moved on"), RescheduledId.Generation, StaleId.Generation);
+
+    FWheelTimerId StaleCopy = StaleId;
+    TestFalse(TEXT("Stale ID is not scheduled"), Wheel.IsScheduled(StaleCopy));
+    TestFalse(TEXT("Stale ID cannot cancel the new timer"), Wheel.Cancel(StaleCopy));
+    TestTrue(TEXT("New timer still scheduled"), Wheel.IsScheduled(RescheduledId));
+    TestEqual(TEXT("Remaining time of the new timer"), Wheel.GetRemainingSeconds(RescheduledId), 20.0);
+
+    // Same once a timer has fired and its node went to the next one
+    Wheel.Advance(20.0, Expired);
+    TestEqual(TEXT("Rescheduled timer fired"), Expired.Num(), 1);
+    TestFalse(TEXT("Fired timer is no longer scheduled"), Wheel.IsScheduled(RescheduledId));
+
+    FWheelTimerId FiredId = RescheduledId;
+    const FWheelTimerId NextId = Wheel.Schedule(5.0, 3);
+    TestEqual(TEXT("Node is reused after firing"), NextId.Index, FiredId.Index);
+    TestFalse(TEXT("Cancelling a fired timer fails"), Wheel.Cancel(FiredId));
+    TestEqual(TEXT("Newer timer untouched"), Wheel.Num(), 1);
+
+    Expired.Reset();
+    Wheel.Advance(5.0, Expired);
+    TestEqual(TEXT("Newer timer fires"), Expired.Num(), 1);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHierarchicalTimerWheelWrapTest, "SurvivalGame.Core.HierarchicalTimerWheel.WrapPastTopLevel",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FHierarchicalTimerWheelWrapTest::RunTest(const FString& Parameters)
+{
+    using namespace HierarchicalTimerWheelTests;
+
+    // Beyond the range of the top level, the timer parks in its last slot and goes around again
+    TestFiresOnTick(*this, 0, WheelRangeTicks + 100);
+    TestFiresOnTick(*this, 1000, WheelRangeTicks - 1);
+    TestFiresOnTick(*this, 1000, WheelRangeTicks);
+
+    // A timer near the end of the range does not disturb one inside it
+    FHierarchicalTimerWheel Wheel(TickSeconds);
+    Wheel.Schedule(static_cast<double>(WheelRangeTicks + 5), 2);
+    Wheel.Schedule(100.0, 1);
+
+    TArray<uint64> Expired;
+    Wheel.Advance(100.0, Expired);
+    TestEqual(TEXT("Near timer fired alone"), Expired.Num(), 1);
+    TestEqual(TEXT("Far timer still pending"), Wheel.Num(), 1);
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
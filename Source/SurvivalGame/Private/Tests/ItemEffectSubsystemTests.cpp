@@ -0,0 +1,164 @@
+// ItemEffectSubsystemTests.cpp
+
+#include "Registry/ItemEffectSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ItemEffectSubsystemTests
+{
+    /** Remaining times are reported at wheel tick resolution */
+    constexpr float TimeTolerance = static_cast<float>(UItemEffectSubsystem::WheelTickSeconds) + UE_KINDA_SMALL_NUMBER;
+
+    /** Bare game world with its subsystems and one target actor, torn down with the scope */
+    struct FTestWorld
+    {
+        UWorld* World = nullptr;
+        UItemEffectSubsystem* Effects = nullptr;
+        AActor* Target = nullptr;
+
+        FTestWorld()
+        {
+            World = UWorld::CreateWorld(EWorldType::Game, false);
+            FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            WorldContext.SetCurrentWorld(World);
+
+            Effects = World->GetSubsystem<UItemEffectSubsystem>();
+            Target = World->SpawnActor<AActor>();
+        }
+
+        ~FTestWorld()
+        {
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        }
+
+        /** Advance the effect clock in frame-sized steps */
+        void Advance(float Seconds) const
+        {
+            constexpr float FrameSeconds = 1.0f / 30.0f;
+            for (; Seconds > UE_KINDA_SMALL_NUMBER; Seconds -= FrameSeconds)
+            {
+                Effects->Tick(FMath::Min(Seconds, FrameSeconds));
+            }
+        }
+    };
+
+    FItemEffectSpec MakeSpec(E_EffectStackPolicy StackPolicy, float Magnitude, float Duration, int32 MaxStacks = 1)
+    {
+        FItemEffectSpec Spec;
+        Spec.Effect = E_ItemEffect::BoostSpeed;
+        Spec.Magnitude = Magnitude;
+        Spec.Duration = Duration;
+        Spec.StackPolicy = StackPolicy;
+        Spec.MaxStacks = MaxStacks;
+        return Spec;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemEffectRefreshPolicyTest, "SurvivalGame.Registry.ItemEffectSubsystem.RefreshPolicy",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemEffectRefreshPolicyTest::RunTest(const FString& Parameters)
+{
+    using namespace ItemEffectSubsystemTests;
+
+    FTestWorld TestWorld;
+    if (!TestNotNull(TEXT("Effect subsystem"), TestWorld.Effects) || !TestNotNull(TEXT("Target"), TestWorld.Target))
+    {
+        return false;
+    }
+    UItemEffectSubsystem* Effects = TestWorld.Effects;
+    AActor* Target = TestWorld.Target;
+
+    Effects->ApplyEffect(Target, MakeSpec(E_EffectStackPolicy::Refresh, 5.0f, 10.0f));
+    TestWorld.Advance(4.0f);
+    TestEqual(TEXT("Time runs down"), Effects->GetEffectRemainingTime(Target, E_ItemEffect::BoostSpeed), 6.0f, TimeTolerance);
+
+    // A weaker reapplication restarts the duration and keeps the stronger magnitude
+    Effects->ApplyEffect(Target, MakeSpec(E_EffectStackPolicy::Refresh, 3.0f, 10.0f));
+    TestEqual(TEXT("Duration restarted"), Effects->GetEffectRemainingTime(Target, E_ItemEffect::BoostSpeed), 10.0f, TimeTolerance);
+    TestEqual(TEXT("Stronger magnitude kept"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 5.0f);
+
+    TestWorld.Advance(9.5f);
+    TestEqual(TEXT("Still active before the refreshed expiry"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 5.0f);
+    TestWorld.Advance(1.0f);
+    TestEqual(TEXT("Expired after the refreshed duration"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 0.0f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemEffectStackPolicyTest, "SurvivalGame.Registry.ItemEffectSubsystem.StackPolicy",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemEffectStackPolicyTest::RunTest(const FString& Parameters)
+{
+    using namespace ItemEffectSubsystemTests;
+
+    FTestWorld TestWorld;
+    if (!TestNotNull(TEXT("Effect subsystem"), TestWorld.Effects) || !TestNotNull(TEXT("Target"), TestWorld.Target))
+    {
+        return false;
+    }
+    UItemEffectSubsystem* Effects = TestWorld.Effects;
+    AActor* Target = TestWorld.Target;
+
+    const FItemEffectSpec Spec = MakeSpec(E_EffectStackPolicy::Stack, 2.0f, 10.0f, 3);
+    Effects->ApplyEffect(Target, Spec);
+    TestEqual(TEXT("One stack"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 2.0f);
+
+    TestWorld.Advance(4.0f);
+    Effects->ApplyEffect(Target, Spec);
+    TestEqual(TEXT("Two stacks"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 4.0f);
+    TestEqual(TEXT("Stacking restarts the duration"), Effects->GetEffectRemainingTime(Target, E_ItemEffect::BoostSpeed), 10.0f, TimeTolerance);
+
+    // Capped at MaxStacks
+    Effects->ApplyEffect(Target, Spec);
+    Effects->ApplyEffect(Target, Spec);
+    TestEqual(TEXT("Capped at three stacks"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 6.0f);
+
+    // Every stack goes at once
+    TestWorld.Advance(10.5f);
+    TestEqual(TEXT("All stacks expired"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 0.0f);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemEffectExtendPolicyTest, "SurvivalGame.Registry.ItemEffectSubsystem.ExtendPolicy",
+    EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FItemEffectExtendPolicyTest::RunTest(const FString& Parameters)
+{
+    using namespace ItemEffectSubsystemTests;
+
+    FTestWorld TestWorld;
+    if (!TestNotNull(TEXT("Effect subsystem"), TestWorld.Effects) || !TestNotNull(TEXT("Target"), TestWorld.Target))
+    {
+        return false;
+    }
+    UItemEffectSubsystem* Effects = TestWorld.Effects;
+    AActor* Target = TestWorld.Target;
+
+    Effects->ApplyEffect(Target, MakeSpec(E_EffectStackPolicy::Extend, 5.0f, 10.0f));
+    TestWorld.Advance(4.0f);
+
+    // The new duration is added to what was left
+    Effects->ApplyEffect(Target, MakeSpec(E_EffectStackPolicy::Extend, 8.0f, 10.0f));
+    TestEqual(TEXT("Duration extended"), Effects->GetEffectRemainingTime(Target, E_ItemEffect::BoostSpeed), 16.0f, TimeTolerance);
+    TestEqual(TEXT("Stronger magnitude taken"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 8.0f);
+
+    TestWorld.Advance(15.5f);
+    TestEqual(TEXT("Still active before the extended expiry"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 8.0f);
+    TestWorld.Advance(1.0f);
+    TestEqual(TEXT("Expired after the extended duration"), Effects->GetEffectMagnitude(Target, E_ItemEffect::BoostSpeed), 0.0f);
+
+    // Removing early cancels the pending expiry
+    Effects->ApplyEffect(Target, MakeSpec(E_EffectStackPolicy::Extend, 5.0f, 10.0f));
+    TestTrue(TEXT("Removed"), Effects->RemoveEffect(Target, E_ItemEffect::BoostSpeed));
+    TestEqual(TEXT("Nothing left to expire"), Effects->GetEffectRemainingTime(Target, E_ItemEffect::BoostSpeed), 0.0f);
+    TestFalse(TEXT("Subsystem stops ticking"), Effects->IsTickable());
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
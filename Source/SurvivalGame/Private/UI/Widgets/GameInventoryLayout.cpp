@@ -34,6 +34,12 @@ void UGameInventoryLayout::NativeOnActivated()
 void UGameInventoryLayout::NativeOnDeactivated()
 {
     Super::NativeOnDeactivated();
+
+    // Closed, nothing still loading is needed any more
+    if (InventoryWidget)
+    {
+        InventoryWidget->CancelPrefetch();
+    }
 }
 
 void UGameInventoryLayout::InitializeTabs()
@@ -67,6 +73,30 @@ void UGameInventoryLayout::SwitchToTab(EInventoryLayoutTab NewTab)
     }
 
     ActiveTab = NewTab;
+
+    // Icons are only requested while the inventory tab is shown
+    if (InventoryWidget)
+    {
+        if (NewTab == EInventoryLayoutTab::Inventory)
+        {
+            InventoryWidget->RefreshPrefetch();
+        }
+        else
+        {
+            InventoryWidget->CancelPrefetch();
+        }
+    }
+}
+
+void UGameInventoryLayout::OpenContainer(UItemContainerBase* Container)
+{
+    if (!ensure(InventoryWidget))
+    {
+        return;
+    }
+
+    InventoryWidget->SetContainer(Container);
+    SwitchToTab(EInventoryLayoutTab::Inventory);
 }
 
 bool UGameInventoryLayout::ValidateWidgetBindings() const
@@ -2,4 +2,285 @@
 
 
 #include "UI/Widgets/InventoryWidget.h"
+#include "Components/Inventory/ItemContainerBase.h"
+#include "Core/SurvivalGameInstance.h"
+#include "Data/PrimaryData/ItemInfo.h"
+#include "Registry/ItemRegistry.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/Texture2D.h"
 
+namespace
+{
+    /** Visible icons and the hovered preview go ahead of the icons of the next pages */
+    constexpr int32 VisiblePriority = UItemAssetCache::DefaultPriority;
+    constexpr int32 PrefetchPriority = UItemAssetCache::DefaultPriority - 10;
+}
+
+UInventoryWidget::UInventoryWidget(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer)
+    , DefaultVisibleSlots(30)
+    , PrefetchPages(1)
+{
+}
+
+void UInventoryWidget::NativeDestruct()
+{
+    Super::NativeDestruct();
+
+    SetContainer(nullptr);
+}
+
+void UInventoryWidget::SetContainer(UItemContainerBase* InContainer)
+{
+    if (UItemContainerBase* OldContainer = Container.Get())
+    {
+        OldContainer->OnContainerUpdated.RemoveDynamic(this, &UInventoryWidget::HandleContainerUpdated);
+        OldContainer->OnSlotsChanged.RemoveDynamic(this, &UInventoryWidget::HandleSlotsChanged);
+    }
+
+    Container = InContainer;
+    FirstVisibleSlot = 0;
+    HoveredSlot = INDEX_NONE;
+    HoveredMeshPath.Reset();
+    HoveredMeshHandle.Reset();
+    CancelHoveredItemInfoRequest();
+
+    if (InContainer)
+    {
+        InContainer->OnContainerUpdated.AddUniqueDynamic(this, &UInventoryWidget::HandleContainerUpdated);
+        InContainer->OnSlotsChanged.AddUniqueDynamic(this, &UInventoryWidget::HandleSlotsChanged);
+    }
+
+    // Request the first pages right away, before the slot view has laid out and reported its range
+    RefreshPrefetch();
+}
+
+void UInventoryWidget::SetVisibleSlots(int32 FirstSlot, int32 NumSlots)
+{
+    FirstSlot = FMath::Max(FirstSlot, 0);
+    NumSlots = FMath::Max(NumSlots, 0);
+    if (FirstSlot == FirstVisibleSlot && NumSlots == NumVisibleSlots)
+    {
+        return;
+    }
+
+    FirstVisibleSlot = FirstSlot;
+    NumVisibleSlots = NumSlots;
+    RefreshPrefetch();
+}
+
+void UInventoryWidget::SetHoveredSlot(int32 SlotIndex)
+{
+    if (SlotIndex == HoveredSlot)
+    {
+        return;
+    }
+
+    HoveredSlot = SlotIndex;
+    RequestHoveredMesh();
+}
+
+UTexture2D* UInventoryWidget::GetSlotIcon(int32 SlotIndex) const
+{
+    const FItemStructure* Item = GetSlotItem(SlotIndex);
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    const UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    const UItemAssetCache* Cache = UItemAssetCache::Get();
+    return Item && Registry && Cache ? Cast<UTexture2D>(Cache->FindAsset(Registry->GetItemIconPath(Item->RegistryKey))) : nullptr;
+}
+
+void UInventoryWidget::RefreshPrefetch()
+{
+    const UItemContainerBase* CurrentContainer = Container.Get();
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    const UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    UItemAssetCache* Cache = UItemAssetCache::Get();
+    if (!CurrentContainer || !Registry || !Cache)
+    {
+        IconRequests.Reset();
+        NumContainerSlots = 0;
+        return;
+    }
+
+    const TArray<FItemStructure>& Items = CurrentContainer->GetItems();
+    const int32 VisibleEnd = FMath::Min(FirstVisibleSlot + GetNumVisibleSlots(), Items.Num());
+    const int32 PrefetchEnd = FMath::Min(GetPrefetchEnd(), Items.Num());
+    NumContainerSlots = Items.Num();
+
+    // The new requests are made before the old ones are dropped, so icons still in range
+    // keep loading and only the ones that left it are cancelled
+    TMap<FSoftObjectPath, FIconRequest> NewRequests;
+    for (int32 SlotIndex = FirstVisibleSlot; SlotIndex < PrefetchEnd; ++SlotIndex)
+    {
+        const FSoftObjectPath Path = Items[SlotIndex].IsEmpty() ? FSoftObjectPath() : Registry->GetItemIconPath(Items[SlotIndex].RegistryKey);
+        if (Path.IsNull())
+        {
+            continue;
+        }
+
+        FIconRequest* Request = NewRequests.Find(Path);
+        if (!Request)
+        {
+            // Requesting again raises the priority of a queued icon that scrolled into view,
+            // only the first request waits for it
+            FSimpleDelegate OnLoaded = IconRequests.Contains(Path)
+                ? FSimpleDelegate()
+                : FSimpleDelegate::CreateUObject(this, &UInventoryWidget::HandleIconLoaded, Path);
+
+            Request = &NewRequests.Add(Path);
+            Request->Handle = Cache->RequestAsset(Path, SlotIndex < VisibleEnd ? VisiblePriority : PrefetchPriority, MoveTemp(OnLoaded));
+        }
+        Request->Slots.Add(SlotIndex);
+    }
+
+    IconRequests = MoveTemp(NewRequests);
+}
+
+void UInventoryWidget::CancelPrefetch()
+{
+    IconRequests.Reset();
+    HoveredSlot = INDEX_NONE;
+    HoveredMeshPath.Reset();
+    HoveredMeshHandle.Reset();
+    CancelHoveredItemInfoRequest();
+}
+
+void UInventoryWidget::HandleContainerUpdated(const TArray<FItemStructure>& Items)
+{
+    // Changed slots come through HandleSlotsChanged, this only has to catch slots dropped off the end
+    if (Items.Num() == NumContainerSlots)
+    {
+        return;
+    }
+
+    RefreshPrefetch();
+    if (HoveredSlot >= Items.Num())
+    {
+        RequestHoveredMesh();
+    }
+}
+
+void UInventoryWidget::HandleSlotsChanged(const TArray<int32>& SlotIndices)
+{
+    const int32 PrefetchEnd = GetPrefetchEnd();
+    bool bRangeChanged = false;
+    bool bHoveredChanged = false;
+    for (int32 SlotIndex : SlotIndices)
+    {
+        bRangeChanged |= SlotIndex >= FirstVisibleSlot && SlotIndex < PrefetchEnd;
+        bHoveredChanged |= SlotIndex == HoveredSlot;
+    }
+
+    if (bRangeChanged)
+    {
+        RefreshPrefetch();
+    }
+    if (bHoveredChanged)
+    {
+        RequestHoveredMesh();
+    }
+}
+
+void UInventoryWidget::HandleIconLoaded(FSoftObjectPath Path)
+{
+    const FIconRequest* Request = IconRequests.Find(Path);
+    UTexture2D* Icon = Request ? Request->Handle.Get<UTexture2D>() : nullptr;
+    if (!Icon)
+    {
+        return;
+    }
+
+    // The event may scroll the view and rebuild the requests, work on a copy
+    const TArray<int32, TInlineAllocator<4>> Slots = Request->Slots;
+    for (int32 SlotIndex : Slots)
+    {
+        OnSlotIconLoaded(SlotIndex, Icon);
+    }
+}
+
+void UInventoryWidget::RequestHoveredMesh()
+{
+    const FItemStructure* Item = GetSlotItem(HoveredSlot);
+    const FName ItemKey = Item ? Item->RegistryKey : NAME_None;
+    const USurvivalGameInstance* GameInstance = USurvivalGameInstance::Get(this);
+    UItemRegistry* Registry = GameInstance ? GameInstance->GetItemRegistry() : nullptr;
+    const UItemInfo* ItemInfo = Item && Registry ? Registry->ResolveItemInfo(*Item) : nullptr;
+    UItemAssetCache* Cache = UItemAssetCache::Get();
+
+    if (ItemKey != HoveredItemInfoKey)
+    {
+        CancelHoveredItemInfoRequest();
+    }
+
+    // Mesh paths are only in the definition. Stream it in and come back, once per item, so a
+    // definition that fails to load does not request again from its own callback.
+    if (!ItemInfo && Registry && !ItemKey.IsNone() && HoveredItemInfoKey.IsNone())
+    {
+        HoveredMeshPath.Reset();
+        HoveredMeshHandle.Reset();
+        HoveredItemInfoKey = ItemKey;
+        HoveredItemInfoRequest = Registry->RequestItemInfos(MakeArrayView(&ItemKey, 1),
+            FSimpleDelegate::CreateUObject(this, &UInventoryWidget::RequestHoveredMesh), FStreamableManager::AsyncLoadHighPriority);
+        return;
+    }
+
+    // Items without a static mesh preview their skeletal one
+    FSoftObjectPath Path;
+    E_ItemAssetKind Kind = E_ItemAssetKind::Mesh;
+    if (ItemInfo && Cache)
+    {
+        Path = ItemInfo->GetAssetPath(Kind);
+        if (Path.IsNull())
+        {
+            Kind = E_ItemAssetKind::SkeletalMesh;
+            Path = ItemInfo->GetAssetPath(Kind);
+        }
+    }
+
+    if (Path == HoveredMeshPath && HoveredMeshHandle.IsValid())
+    {
+        return;
+    }
+
+    // Assigned after the request, so a shared entry is not cancelled and restarted, while the
+    // previous item's mesh is cancelled if it had not loaded yet
+    HoveredMeshPath = Path;
+    FItemAssetHandle NewHandle;
+    if (!Path.IsNull())
+    {
+        NewHandle = Cache->RequestItemAsset(ItemInfo, Kind, VisiblePriority,
+            FSimpleDelegate::CreateUObject(this, &UInventoryWidget::HandleHoveredMeshLoaded, Path));
+    }
+    HoveredMeshHandle = MoveTemp(NewHandle);
+}
+
+void UInventoryWidget::HandleHoveredMeshLoaded(FSoftObjectPath Path)
+{
+    // Also runs inside the request when the mesh is already resident, so look it up by path
+    const UItemAssetCache* Cache = UItemAssetCache::Get();
+    UObject* Mesh = Cache && Path == HoveredMeshPath ? Cache->FindAsset(Path) : nullptr;
+    if (Mesh)
+    {
+        OnHoveredMeshLoaded(HoveredSlot, Mesh);
+    }
+}
+
+void UInventoryWidget::CancelHoveredItemInfoRequest()
+{
+    if (HoveredItemInfoRequest.IsValid())
+    {
+        HoveredItemInfoRequest->CancelHandle();
+        HoveredItemInfoRequest.Reset();
+    }
+    HoveredItemInfoKey = NAME_None;
+}
+
+const FItemStructure* UInventoryWidget::GetSlotItem(int32 SlotIndex) const
+{
+    const UItemContainerBase* CurrentContainer = Container.Get();
+    if (!CurrentContainer || !CurrentContainer->GetItems().IsValidIndex(SlotIndex) || CurrentContainer->IsSlotEmpty(SlotIndex))
+    {
+        return nullptr;
+    }
+    return &CurrentContainer->GetItems()[SlotIndex];
+}
@@ -44,6 +44,14 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "Inventory|Config")
     float BaseWeightLimit;
 
+    /** Search radius for TransferToNearbyContainer */
+    UPROPERTY(EditDefaultsOnly, Category = "Inventory|Config", meta = (ClampMin = "0.0", Units = "cm"))
+    float TransferRadius;
+
+    /** Minimum time between OnWeightChanged broadcasts on the server */
+    UPROPERTY(EditDefaultsOnly, Category = "Inventory|Config", meta = (ClampMin = "0.0", Units = "s"))
+    float WeightChangedInterval;
+
     /** Item handling rules */
     UPROPERTY(EditDefaultsOnly, Category = "Inventory|Rules")
     bool bAutoStackItems;
@@ -77,9 +85,18 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Inventory|Operations")
     bool ExpandInventory(int32 AdditionalSlots);
 
+    /** Move everything into the closest container within TransferRadius */
     UFUNCTION(BlueprintCallable, Category = "Inventory|Operations")
     bool TransferToNearbyContainer();
 
+    /** Closest container within TransferRadius that this player is allowed to reach into */
+    UFUNCTION(BlueprintPure, Category = "Inventory|Operations")
+    UItemContainerBase* FindNearbyContainer() const;
+
+    /** Use one consumable from a slot and apply its effects to the owner */
+    UFUNCTION(BlueprintCallable, Category = "Inventory|Operations")
+    bool ConsumeItem(int32 SlotIndex);
+
     /** Weight management */
     UFUNCTION(BlueprintPure, Category = "Inventory|Weight")
     float GetCurrentWeight() const { return CurrentWeight; }
@@ -93,6 +110,7 @@ public:
 protected:
     /** Override base container validation */
     virtual bool ValidateItem(const FItemStructure& Item) const override;
+    virtual int32 GetAcceptableQuantity(const FItemStructure& Item) const override;
     
     /** Additional validation methods */
     bool CheckWeightLimit(const FItemStructure& Item) const;
@@ -103,11 +121,29 @@ protected:
     UFUNCTION()
     void OnRep_CurrentWeight();
 
-    /** Weight calculations */
-    void UpdateCurrentWeight();
+    UFUNCTION(Server, Reliable)
+    void Server_ConsumeItem(int32 SlotIndex);
+
+    bool ConsumeItemInternal(int32 SlotIndex);
+
+    /** Weight calculations, kept as a running total fed by the slot index */
+    virtual void OnStackQuantityChanged(const FItemStructure& Item, int32 QuantityDelta) override;
+    virtual void OnSlotIndexReset() override;
     float CalculateItemWeight(const FItemStructure& Item) const;
+    float GetUnitWeight(const FItemStructure& Item) const;
+
+    /** Rate-limited OnWeightChanged */
+    void RequestWeightChangedBroadcast();
+    void HandleWeightChangedTimer();
 
     /** Internal helpers */
     void InitializeInventory();
     void HandleInventoryExpansion(int32 NewSize);
+
+private:
+    /** Running weight total, double so long add/remove sequences do not drift */
+    double RunningWeight = 0.0;
+
+    FTimerHandle WeightChangedTimerHandle;
+    bool bWeightChangedPending = false;
 };
\ No newline at end of file
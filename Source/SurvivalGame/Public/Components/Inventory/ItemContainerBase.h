@@ -5,11 +5,21 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Data/Struct/ItemStructure.h"
+#include "Components/Inventory/ItemSlotArray.h"
+#include "Components/Inventory/ItemContainerOps.h"
+#include "Components/Inventory/ItemSlotKernels.h"
 #include "Enums/ContainerType.h"
 #include "ItemContainerBase.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnContainerUpdated, const TArray<FItemStructure>&, Items);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSlotUpdated, int32, SlotIndex, const FItemStructure&, Item);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSlotsChanged, const TArray<int32>&, SlotIndices);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnContainerOpsAcknowledged, int32, Sequence, bool, bAccepted);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSlotItemDecayed, int32, SlotIndex, const FItemStructure&, Item);
+
+class UItemRegistry;
+class UContainerSubsystem;
+class UNetConnection;
 
 /**
  * @brief Base component class for handling item storage and management
@@ -32,6 +42,7 @@ public:
 
     virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 protected:
     /** Container configuration */
@@ -44,17 +55,35 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "Container|Config")
     bool bAllowStacking;
 
-    /** Container state */
-    UPROPERTY(ReplicatedUsing = OnRep_Items, EditAnywhere, BlueprintReadWrite, Blueprintable, Category = "Item Structure")
+    /** Furthest distance between owners for transfers with another actor's container */
+    UPROPERTY(EditDefaultsOnly, Category = "Container|Config", meta = (ClampMin = "0.0", Units = "cm"))
+    float MaxTransferDistance;
+
+    /** Container state, indexed by slot. Mirrors ReplicatedSlots on every machine */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Structure")
     TArray<FItemStructure> Items;
 
+    /** Delta-replicated slot list, only dirty slots are sent to clients */
+    UPROPERTY(Replicated)
+    FItemSlotArray ReplicatedSlots;
+
     /** Cached owner reference */
     UPROPERTY()
     AActor* OwningActor;
 
-    /** Network replication */
+    /** Network replication, called by ReplicatedSlots on clients */
+    friend struct FItemSlotEntry;
+    friend struct FItemSlotArray;
+    void HandleReplicatedSlotChanged(int32 SlotIndex, const FItemStructure& Item);
+    void HandleReplicatedSlotRemoved(int32 SlotIndex);
+    void HandleReplicatedSlotsReceived();
+
+    /** Latest op batch applied by the server, only relevant to the owning client */
+    UPROPERTY(ReplicatedUsing = OnRep_OpAck)
+    FItemContainerOpAck OpAck;
+
     UFUNCTION()
-    void OnRep_Items();
+    void OnRep_OpAck();
 
 public:
     /** Core container operations */
@@ -64,12 +93,80 @@ public:
     UFUNCTION(BlueprintPure, Category = "Container|Operations")
     bool CanAddItem(const FItemStructure& Item, int32 TargetSlot = -1) const;
 
+    /**
+     * Add several stacks at once. Each stack is capped by GetAcceptableQuantity, then tops up
+     * compatible partial stacks and overflows into free slots. All changes replicate and
+     * notify as one pass. Clients can only add to containers they own.
+     * @param OutRemainders Quantity of each input stack that did not fit, in input order
+     * @return true if every stack was added completely
+     */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool AddItems(const TArray<FItemStructure>& Stacks, TArray<int32>& OutRemainders);
+
     UFUNCTION(BlueprintCallable, Category = "Container|Operations")
     bool RemoveItem(int32 SlotIndex, int32 Amount = 1);
 
     UFUNCTION(BlueprintPure, Category = "Container|Operations")
     bool HasItem(const FName& ItemID, int32& OutQuantity) const;
 
+    /** Move a slot onto another, stacking when compatible and swapping otherwise */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool MoveItem(int32 FromSlot, int32 ToSlot);
+
+    /** Move Amount items from a stack into an empty slot */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool SplitStack(int32 FromSlot, int32 ToSlot, int32 Amount);
+
+    /** Move up to Amount items (0 = all) onto a compatible stack */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool MergeStacks(int32 FromSlot, int32 ToSlot, int32 Amount = 0);
+
+    /**
+     * Merge compatible stacks and reorder the container, packing items into the first slots.
+     * Runs as a single operation, so a client sends one request and every moved slot
+     * replicates in the same update.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool Sort(E_SortMethod Method);
+
+    /**
+     * Move items into another container as one transaction on both sides. Capacity and the
+     * destination's rules (e.g. weight) are checked per stack before anything is written.
+     * Clients send a single request and receive the result through replication.
+     * @return true if anything was transferred (on clients, if the request was sent)
+     */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    bool TransferItems(UItemContainerBase* Destination, const FItemTransferRequest& Request);
+
+    /**
+     * Apply a list of operations as one transaction. On clients the operations are
+     * predicted locally, then queued and sent to the server in a single batch at the
+     * end of the frame.
+     * @return false if any operation failed, in which case nothing is applied
+     */
+    bool ApplyOps(TConstArrayView<FItemContainerOp> Ops);
+
+    /**
+     * Defer slot notifications until the matching EndNotificationBatch. Writes outside a
+     * batch are coalesced until the next frame instead.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    void BeginNotificationBatch();
+
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    void EndNotificationBatch();
+
+    /** RAII helper for BeginNotificationBatch/EndNotificationBatch */
+    struct FNotificationBatchScope
+    {
+        explicit FNotificationBatchScope(UItemContainerBase* InContainer) : Container(InContainer) { Container->BeginNotificationBatch(); }
+        ~FNotificationBatchScope() { Container->EndNotificationBatch(); }
+        UE_NONCOPYABLE(FNotificationBatchScope);
+
+    private:
+        UItemContainerBase* Container;
+    };
+
     /** Container queries */
     UFUNCTION(BlueprintPure, Category = "Container|Queries")
     int32 GetFirstEmptySlot() const;
@@ -80,6 +177,35 @@ public:
     UFUNCTION(BlueprintPure, Category = "Container|Queries")
     const TArray<FItemStructure>& GetItems() const { return Items; }
 
+    UFUNCTION(BlueprintPure, Category = "Container|Queries")
+    E_ContainerType GetContainerType() const { return ContainerType; }
+
+    /** Durability of a slot's item right now, including decay since it was last updated */
+    UFUNCTION(BlueprintPure, Category = "Container|Queries")
+    int32 GetSlotDurability(int32 SlotIndex) const;
+
+    /**
+     * Server: write decayed durability back into every decaying slot, e.g. before saving.
+     * Between calls durability is only evaluated, never stored.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    void MaterializeDecay();
+
+    /**
+     * Server: switch items whose durability ran out to Broken or Spoiled and fire their events.
+     * Returns immediately until the earliest expiry in the container has passed.
+     * Called by UItemDecaySubsystem's sweep.
+     */
+    void ProcessDecay(double Now);
+
+    /** Call after SetOwner on the hosting actor so owner queries see the change, pawns are tracked already */
+    UFUNCTION(BlueprintCallable, Category = "Container|Operations")
+    void NotifyOwnerChanged();
+
+    /** World-unique ID assigned by UContainerSubsystem, INDEX_NONE while unregistered */
+    UFUNCTION(BlueprintPure, Category = "Container|Queries")
+    int32 GetContainerId() const { return ContainerId; }
+
     /** Events */
     UPROPERTY(BlueprintAssignable, Category = "Container|Events")
     FOnContainerUpdated OnContainerUpdated;
@@ -87,20 +213,177 @@ public:
     UPROPERTY(BlueprintAssignable, Category = "Container|Events")
     FOnSlotUpdated OnSlotUpdated;
 
+    /** Coalesced change event, fired once per frame or batch with every dirty slot */
+    UPROPERTY(BlueprintAssignable, Category = "Container|Events")
+    FOnSlotsChanged OnSlotsChanged;
+
+    /** Fired on the owning client when the server has processed an op batch */
+    UPROPERTY(BlueprintAssignable, Category = "Container|Events")
+    FOnContainerOpsAcknowledged OnOpsAcknowledged;
+
+    /** Fired on the server when decay takes an item's durability to zero */
+    UPROPERTY(BlueprintAssignable, Category = "Container|Events")
+    FOnSlotItemDecayed OnItemBroken;
+
+    UPROPERTY(BlueprintAssignable, Category = "Container|Events")
+    FOnSlotItemDecayed OnItemSpoiled;
+
 protected:
     /** Server-side validation */
     bool ValidateSlotIndex(int32 SlotIndex) const;
     virtual bool ValidateItem(const FItemStructure& Item) const;  // Added virtual keyword
 
+    /** How many units of Item this container's rules accept right now, ignoring slot space */
+    virtual int32 GetAcceptableQuantity(const FItemStructure& Item) const;
+
+    /** Whether two containers are close enough to exchange items */
+    static bool IsWithinTransferRange(const UItemContainerBase* A, const UItemContainerBase* B);
+
+    /**
+     * Whether the player on Connection may move items in or out of a container: its own
+     * containers and unowned world storage, never another player's containers or any
+     * player inventory but its own (including those of disconnected players)
+     */
+    static bool CanConnectionAccess(const UItemContainerBase* Container, const UNetConnection* Connection);
+
     /** Helper functions */
     void InitializeContainer();
+    void ResizeContainer(int32 NewNumSlots);
     void UpdateSlot(int32 SlotIndex, const FItemStructure& Item);
+    void CommitSlot(int32 SlotIndex);
     void NotifyContainerUpdated();
-    
-    /** Server RPC */
+
+    /** Slot query index, every write to Items goes through SetSlotIndexed */
+    void SetSlotIndexed(int32 SlotIndex, const FItemStructure& Item);
+    void IndexSlot(int32 SlotIndex);
+    void UnindexSlot(int32 SlotIndex);
+    void RebuildSlotIndex();
+
+    /** Swap fallback slot IDs for registry handles once the registry is ready */
+    void HandleItemRegistryInitialized();
+
+    /** First slot at or after StartIndex holding a stack Item can be added to, INDEX_NONE if none */
+    int32 FindStackWithSpace(const FItemStructure& Item, int32 StartIndex = 0) const;
+
+    /**
+     * Item ID used by SlotColumns, INDEX_NONE if never stored. This is the registry handle,
+     * items without one fall back to per-container IDs above the handle range.
+     */
+    int32 FindSlotItemId(const FItemStructure& Item) const;
+    int32 FindSlotItemId(FName RegistryKey) const;
+    int32 InternSlotItemId(const FItemStructure& Item);
+
+    /**
+     * Called for every quantity change in the slot index (negative when a stack shrinks or leaves).
+     * Subclasses keep running totals here instead of rescanning Items.
+     */
+    virtual void OnStackQuantityChanged(const FItemStructure& Item, int32 QuantityDelta) {}
+
+    /** Called when the slot index is rebuilt from scratch, before every slot is re-added */
+    virtual void OnSlotIndexReset() {}
+
+    /** Server: flag the container in UContainerSubsystem's dirty index */
+    void MarkContainerDirty();
+
+    /** Notification coalescing */
+    void MarkSlotDirty(int32 SlotIndex);
+    void FlushSlotNotifications();
+    UItemRegistry* GetItemRegistry() const;
+
+    /** Whether the owning actor belongs to this machine's player, the only case a client may send server RPCs */
+    bool IsOwnedByLocalPlayer() const;
+
+    /** Transactional slot writes, originals are journaled so a failed batch can be rolled back */
+    void BeginSlotTransaction();
+    void EndSlotTransaction(bool bCommit);
+    void WriteSlot(int32 SlotIndex, const FItemStructure& Item);
+    void WriteSlotQuantity(int32 SlotIndex, int32 NewQuantity);
+
+    /** Add Amount items of Source onto the stack in SlotIndex, blending their decay state */
+    void WriteStackedQuantity(int32 SlotIndex, const FItemStructure& Source, int32 Amount);
+
+    /** Apply operations inside one slot transaction, rolling back on the first failure */
+    bool ApplyOpsTransaction(TConstArrayView<FItemContainerOp> Ops);
+
+    /** Operation primitives, only valid inside a slot transaction */
+    bool ApplyOp(const FItemContainerOp& Op);
+    bool AddItemInternal(const FItemStructure& Item, int32 TargetSlot);
+    int32 DistributeItemInternal(const FItemStructure& Item);
+    bool RemoveItemInternal(int32 SlotIndex, int32 Amount);
+    bool MoveItemInternal(int32 FromSlot, int32 ToSlot);
+    bool SplitStackInternal(int32 FromSlot, int32 ToSlot, int32 Amount);
+    bool MergeStacksInternal(int32 FromSlot, int32 ToSlot, int32 Amount);
+    bool SortInternal(E_SortMethod Method);
+
+    /** Server-side transfer, returns the number of units moved (0 if rolled back) */
+    int32 TransferItemsInternal(UItemContainerBase* Destination, const FItemTransferRequest& Request);
+
+    /** Client-side batching */
+    void QueueOp(const FItemContainerOp& Op);
+    void FlushPendingOps();
+
+    /** Client-side prediction, rebuilds Items from the server state plus unacknowledged ops */
+    void RequestReconcile();
+    void ReconcilePredictedState();
+
+    /** Server RPC, one reliable call per batch */
     UFUNCTION(Server, Reliable)
-    void Server_AddItem(const FItemStructure& Item, int32 TargetSlot);
+    void Server_ApplyOps(const FItemContainerOpBatch& Batch);
 
+    /** Server RPC for transfers, sent through whichever of the two containers the client owns */
     UFUNCTION(Server, Reliable)
-    void Server_RemoveItem(int32 SlotIndex, int32 Amount);
+    void Server_TransferItems(UItemContainerBase* Source, UItemContainerBase* Destination, const FItemTransferRequest& Request);
+
+    /** Upper bound on operations accepted in a single batch */
+    static constexpr int32 MaxOpsPerBatch = 128;
+
+private:
+    /** Registry state, owned by UContainerSubsystem */
+    friend class UContainerSubsystem;
+    int32 ContainerId = INDEX_NONE;
+    bool bDirtyInRegistry = false;
+
+    /** Original contents of slots written during the current transaction */
+    TMap<int32, FItemStructure> SlotJournal;
+    bool bInSlotTransaction = false;
+
+    /** Operations waiting to be sent at the end of the frame */
+    TArray<FItemContainerOp> PendingOps;
+    int32 NextOpSequence = 0;
+
+    /** Batch sent to the server but not yet acknowledged */
+    struct FPredictedOpBatch
+    {
+        int32 Sequence;
+        TArray<FItemContainerOp> Ops;
+    };
+    TArray<FPredictedOpBatch> PredictedBatches;
+
+    /** Last state confirmed by replication (clients only), Items holds the predicted view */
+    TArray<FItemStructure> ServerItems;
+
+    /** Snapshot slots whose contents changed since the last reconcile */
+    TBitArray<> ChangedServerSlots;
+    bool bServerSlotsRemoved = false;
+    bool bReconcilePending = false;
+    bool bReplayingPredictions = false;
+
+    /** Predictions were dropped without an ack, the next reconcile rebuilds from the server state */
+    bool bPredictionsDiscarded = false;
+
+    /** Earliest decay expiry among the slots, may be early after removals but never late */
+    double NextDecayTime = MAX_dbl;
+
+    /** Hot fields of Items as parallel arrays, searched with the slot kernels */
+    FItemSlotColumns SlotColumns;
+    TMap<FName, int32> UnhandledSlotItemIds;
+
+    /** One bit per slot, set when the slot is empty */
+    TBitArray<> FreeSlots;
+    int32 NumFreeSlots = 0;
+
+    /** Slots written since the last notification flush */
+    TBitArray<> DirtySlots;
+    int32 NotificationBatchDepth = 0;
+    bool bNotificationFlushScheduled = false;
 };
\ No newline at end of file
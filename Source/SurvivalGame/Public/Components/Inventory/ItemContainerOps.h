@@ -0,0 +1,166 @@
+// ItemContainerOps.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Enums/ItemEnums.h"
+#include "Data/Struct/ItemHandle.h"
+#include "ItemContainerOps.generated.h"
+
+struct FItemStructure;
+
+/**
+ * @brief Operations a client can request on a container
+ */
+UENUM(BlueprintType)
+enum class E_ContainerOpType : uint8
+{
+    None    UMETA(DisplayName = "None"),
+    Add     UMETA(DisplayName = "Add"),
+    Remove  UMETA(DisplayName = "Remove"),
+    Move    UMETA(DisplayName = "Move"),
+    Split   UMETA(DisplayName = "Split"),
+    Merge   UMETA(DisplayName = "Merge"),
+    Sort    UMETA(DisplayName = "Sort")
+};
+
+/**
+ * @brief A single container operation, addressed by slot index and item handle
+ *
+ * Slot usage per type:
+ * - Add:    ItemHandle (or RegistryKey when it has none) x Quantity into TargetSlot (or any slot when INDEX_NONE)
+ * - Remove: Quantity from SlotIndex
+ * - Move:   SlotIndex to TargetSlot, stacking or swapping with its contents
+ * - Split:  Quantity from SlotIndex into the empty TargetSlot
+ * - Merge:  Quantity (0 = all) from SlotIndex onto the compatible stack in TargetSlot
+ * - Sort:   Merge stacks and reorder the whole container, Quantity holds the E_SortMethod
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemContainerOp
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    E_ContainerOpType Type;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    int32 SlotIndex;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    int32 TargetSlot;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    FName RegistryKey;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    FItemHandle ItemHandle;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Operation")
+    int32 Quantity;
+
+    FItemContainerOp()
+        : Type(E_ContainerOpType::None)
+        , SlotIndex(INDEX_NONE)
+        , TargetSlot(INDEX_NONE)
+        , RegistryKey(NAME_None)
+        , Quantity(0)
+    {
+    }
+
+    static FItemContainerOp MakeAdd(const FItemStructure& Item, int32 InQuantity, int32 InTargetSlot);
+    static FItemContainerOp MakeRemove(int32 InSlotIndex, int32 InQuantity);
+    static FItemContainerOp MakeMove(int32 InSlotIndex, int32 InTargetSlot);
+    static FItemContainerOp MakeSplit(int32 InSlotIndex, int32 InTargetSlot, int32 InQuantity);
+    static FItemContainerOp MakeMerge(int32 InSlotIndex, int32 InTargetSlot, int32 InQuantity);
+    static FItemContainerOp MakeSort(E_SortMethod InMethod);
+
+    /** Packed wire format: type, packed slot indices and quantity, verified handle (or key) only for adds */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemContainerOp> : public TStructOpsTypeTraitsBase2<FItemContainerOp>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
+
+/**
+ * @brief Ordered list of operations applied by the server as one transaction
+ */
+USTRUCT()
+struct SURVIVALGAME_API FItemContainerOpBatch
+{
+    GENERATED_BODY()
+
+    /** Client-assigned, increases by one per batch */
+    UPROPERTY()
+    int32 Sequence = 0;
+
+    UPROPERTY()
+    TArray<FItemContainerOp> Ops;
+};
+
+/**
+ * @brief Which items a container-to-container transfer moves
+ */
+UENUM(BlueprintType)
+enum class E_TransferMode : uint8
+{
+    All                 UMETA(DisplayName = "All"),
+    MatchingType        UMETA(DisplayName = "Matching Type"),
+    MatchingCategory    UMETA(DisplayName = "Matching Category"),
+    ItemQuantity        UMETA(DisplayName = "Item Quantity")
+};
+
+/**
+ * @brief Filter and amount for UItemContainerBase::TransferItems
+ *
+ * All, MatchingType and MatchingCategory move as much as the destination accepts.
+ * ItemQuantity moves exactly Quantity of RegistryKey or nothing.
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemTransferRequest
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Transfer")
+    E_TransferMode Mode = E_TransferMode::All;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Transfer")
+    E_ItemType ItemType = E_ItemType::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Transfer")
+    E_ItemCategory ItemCategory = E_ItemCategory::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Transfer")
+    FName RegistryKey;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Transfer")
+    int32 Quantity = 0;
+
+    static FItemTransferRequest MakeAll();
+    static FItemTransferRequest MakeType(E_ItemType InItemType);
+    static FItemTransferRequest MakeCategory(E_ItemCategory InItemCategory);
+    static FItemTransferRequest MakeItem(FName InRegistryKey, int32 InQuantity);
+
+    /** Whether a stack passes the filter, ignoring the amount */
+    bool Matches(const FItemStructure& Item) const;
+};
+
+/**
+ * @brief Server acknowledgement of the latest applied batch
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemContainerOpAck
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Operation")
+    int32 Sequence = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Operation")
+    bool bAccepted = false;
+};
@@ -0,0 +1,85 @@
+// ItemSlotArray.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "Data/Struct/ItemStructure.h"
+#include "ItemSlotArray.generated.h"
+
+class UItemContainerBase;
+struct FItemSlotArray;
+
+/**
+ * @brief A single replicated container slot
+ *
+ * Slots are addressed by SlotIndex rather than by array position, because the
+ * fast array serializer does not preserve element order on clients.
+ */
+USTRUCT()
+struct SURVIVALGAME_API FItemSlotEntry : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    /** Index of the container slot this entry mirrors */
+    UPROPERTY()
+    int32 SlotIndex = INDEX_NONE;
+
+    /** Item stored in the slot (empty structure for free slots) */
+    UPROPERTY()
+    FItemStructure Item;
+
+    /** Client-side fast array callbacks */
+    void PreReplicatedRemove(const FItemSlotArray& InArraySerializer);
+    void PostReplicatedAdd(const FItemSlotArray& InArraySerializer);
+    void PostReplicatedChange(const FItemSlotArray& InArraySerializer);
+};
+
+/**
+ * @brief Delta-replicated list of container slots
+ *
+ * Only slots marked dirty on the server are sent to clients, and each received
+ * slot is routed back to the owning container individually.
+ */
+USTRUCT()
+struct SURVIVALGAME_API FItemSlotArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    FItemSlotArray() : Owner(nullptr) {}
+    explicit FItemSlotArray(UItemContainerBase* InOwner) : Owner(InOwner) {}
+
+    /** Server: grow or shrink to the given slot count, keeping entries in slot order */
+    void SetNumSlots(int32 NumSlots);
+
+    /** Server: write a slot and mark it for replication */
+    void SetSlot(int32 SlotIndex, const FItemStructure& Item);
+
+    /** Fast array client callback, fired once per received update */
+    void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FItemSlotEntry, FItemSlotArray>(Entries, DeltaParms, *this);
+    }
+
+    /** Container that receives the client-side slot callbacks */
+    UItemContainerBase* GetOwner() const { return Owner; }
+
+private:
+    /** Replicated slot entries (server keeps them ordered by SlotIndex) */
+    UPROPERTY()
+    TArray<FItemSlotEntry> Entries;
+
+    /** Not a UPROPERTY so it is never copied over from the archetype */
+    UItemContainerBase* Owner;
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemSlotArray> : public TStructOpsTypeTraitsBase2<FItemSlotArray>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
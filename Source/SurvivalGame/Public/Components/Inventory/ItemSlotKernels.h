@@ -0,0 +1,68 @@
+// ItemSlotKernels.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Struct/ItemStructure.h"
+
+/**
+ * @brief Hot slot fields of a container stored as parallel arrays
+ *
+ * FItemStructure is several hundred bytes, so scanning Items touches at least one cache
+ * line per slot. Searches run over these columns instead, four slots per instruction.
+ * Item IDs are registry item handles (see UItemContainerBase::InternSlotItemId), 0 marks an empty slot.
+ */
+struct SURVIVALGAME_API FItemSlotColumns
+{
+    TArray<int32> ItemIds;
+
+    TArray<int32> Quantities;
+
+    /** MaxStackSize for stackable items, 0 otherwise, so a slot has space when Limit > Quantity */
+    TArray<int32> StackLimits;
+
+    TArray<int32> Durabilities;
+
+    TArray<uint8> States;
+
+    int32 Num() const { return ItemIds.Num(); }
+
+    /** Grow or shrink, new slots are empty */
+    void SetNum(int32 NumSlots);
+
+    void SetSlot(int32 SlotIndex, int32 ItemId, const FItemStructure& Item);
+    void ClearSlot(int32 SlotIndex);
+};
+
+/**
+ * SIMD search kernels over FItemSlotColumns, with scalar tails for the last few slots
+ */
+namespace ItemSlotKernels
+{
+    /** Sum of Quantities over the slots holding ItemId */
+    SURVIVALGAME_API int32 CountQuantity(const int32* ItemIds, const int32* Quantities, int32 Num, int32 ItemId);
+
+    /** First slot at or after StartIndex holding ItemId, INDEX_NONE if there is none */
+    SURVIVALGAME_API int32 FindFirst(const int32* ItemIds, int32 Num, int32 ItemId, int32 StartIndex = 0);
+
+    /** First slot at or after StartIndex holding ItemId in State with stack space left */
+    SURVIVALGAME_API int32 FindFirstWithSpace(const int32* ItemIds, const int32* Quantities, const int32* StackLimits,
+        const uint8* States, int32 Num, int32 ItemId, uint8 State, int32 StartIndex = 0);
+
+    /** Convenience overloads over a whole column set */
+    FORCEINLINE int32 CountQuantity(const FItemSlotColumns& Columns, int32 ItemId)
+    {
+        return CountQuantity(Columns.ItemIds.GetData(), Columns.Quantities.GetData(), Columns.Num(), ItemId);
+    }
+
+    FORCEINLINE int32 FindFirst(const FItemSlotColumns& Columns, int32 ItemId, int32 StartIndex = 0)
+    {
+        return FindFirst(Columns.ItemIds.GetData(), Columns.Num(), ItemId, StartIndex);
+    }
+
+    FORCEINLINE int32 FindFirstWithSpace(const FItemSlotColumns& Columns, int32 ItemId, uint8 State, int32 StartIndex = 0)
+    {
+        return FindFirstWithSpace(Columns.ItemIds.GetData(), Columns.Quantities.GetData(), Columns.StackLimits.GetData(),
+            Columns.States.GetData(), Columns.Num(), ItemId, State, StartIndex);
+    }
+}
@@ -0,0 +1,89 @@
+// HierarchicalTimerWheel.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Identifies a timer scheduled on an FHierarchicalTimerWheel
+ *
+ * Carries a generation counter, so an ID kept after its timer fired or was cancelled
+ * never matches a newer timer that reuses the same node.
+ */
+struct FWheelTimerId
+{
+    int32 Index = INDEX_NONE;
+    uint32 Generation = 0;
+
+    bool IsValid() const { return Index != INDEX_NONE; }
+    void Invalidate() { Index = INDEX_NONE; }
+
+    bool operator==(const FWheelTimerId& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+    bool operator!=(const FWheelTimerId& Other) const { return !(*this == Other); }
+};
+
+/**
+ * @brief Hierarchical timer wheel with constant-time schedule and cancel
+ *
+ * Time advances in fixed ticks. Level 0 holds the next 64 ticks one slot per tick, each
+ * level above covers 64 times the range of the one below, and its slots are redistributed
+ * downwards when the level below wraps. Timers are nodes in a pooled array linked into
+ * their slot, so scheduling and cancelling never search or allocate once the pool is warm.
+ *
+ * Plain C++ with no engine or world dependency, the owner drives it with Advance.
+ */
+class SURVIVALGAME_API FHierarchicalTimerWheel
+{
+public:
+    explicit FHierarchicalTimerWheel(double InTickSeconds = 0.05);
+
+    /** Schedule Payload to expire after DelaySeconds (at least one tick) */
+    FWheelTimerId Schedule(double DelaySeconds, uint64 Payload);
+
+    /** Cancel a pending timer, returns false if it already fired or was cancelled */
+    bool Cancel(FWheelTimerId& TimerId);
+
+    bool IsScheduled(const FWheelTimerId& TimerId) const;
+
+    /** Seconds until a pending timer fires, 0 if it is not scheduled */
+    double GetRemainingSeconds(const FWheelTimerId& TimerId) const;
+
+    /** Advance the clock and append the payloads of every timer that expired, in expiry order */
+    void Advance(double DeltaSeconds, TArray<uint64>& OutExpired);
+
+    /** Number of pending timers */
+    int32 Num() const { return NumScheduled; }
+
+    double GetTickSeconds() const { return TickSeconds; }
+
+private:
+    static constexpr int32 SlotBits = 6;
+    static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+    static constexpr int32 NumLevels = 4;
+    static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+
+    struct FNode
+    {
+        uint64 ExpireTick = 0;
+        uint64 Payload = 0;
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        int32 Bucket = INDEX_NONE;
+        uint32 Generation = 0;
+    };
+
+    void Link(int32 NodeIndex);
+    void Unlink(int32 NodeIndex);
+    void Release(int32 NodeIndex);
+    void Cascade(int32 Level);
+    void ProcessTick(TArray<uint64>& OutExpired);
+
+    double TickSeconds;
+    double PendingSeconds = 0.0;
+    uint64 CurrentTick = 0;
+    int32 NumScheduled = 0;
+
+    TArray<FNode> Nodes;
+    int32 FreeList = INDEX_NONE;
+    int32 Heads[NumLevels * SlotsPerLevel];
+};
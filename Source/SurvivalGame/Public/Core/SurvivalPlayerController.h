@@ -18,6 +18,13 @@ class SURVIVALGAME_API ASurvivalPlayerController : public APlayerController
 public:
     ASurvivalPlayerController();
 
+    /**
+     * Item handles below this count resolve to the same item on both ends of this player's
+     * connection, checked against the server's catalog once the player logs in. 0 until then
+     * or if the catalogs differ, items are sent by registry key (see UItemRegistry::IsHandleVerified).
+     */
+    int32 GetNumVerifiedItemHandles() const { return NumVerifiedItemHandles; }
+
 protected:
     virtual void BeginPlay() override;
     virtual void SetupInputComponent() override;
@@ -41,7 +48,20 @@ protected:
     UFUNCTION(Client, Reliable)
     void InventoryOnClient();
 
+    /** Item catalog handshake: the server sends its handle table checksum, the client confirms a match */
+    UFUNCTION(Client, Reliable)
+    void Client_VerifyItemCatalog(int32 NumHandles, uint32 Checksum);
+
+    UFUNCTION(Server, Reliable)
+    void Server_ConfirmItemCatalog(int32 NumHandles, uint32 Checksum);
+
+    void SendItemCatalog();
+    void VerifyItemCatalog(int32 NumHandles, uint32 Checksum);
+
     /** Helper functions */
     void UpdateInputMode(bool bShowUI);
     void SetMouseCursorVisibility(bool bShow);
+
+private:
+    int32 NumVerifiedItemHandles = 0;
 };
\ No newline at end of file
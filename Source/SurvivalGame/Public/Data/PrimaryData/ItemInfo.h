@@ -8,8 +8,10 @@
 #include "Sound/SoundBase.h"
 #include "Engine/StreamableManager.h"
 #include "Engine/AssetManager.h"
+#include "GameplayTagContainer.h"
 #include "SurvivalGame/Public/Enums/ItemEnums.h"
 #include "SurvivalGame/Public/Data/Struct/ItemStructure.h"
+#include "SurvivalGame/Public/Registry/ItemAssetCache.h"
 #include "ItemInfo.generated.h"
 
 class UStaticMesh;
@@ -32,28 +34,55 @@ class SURVIVALGAME_API UItemInfo : public UPrimaryDataAsset
 public:
     UItemInfo();
 
+    /** Primary asset type, must match the type scanned in the asset manager settings */
+    static const FPrimaryAssetType PrimaryAssetType;
+
+    /** Asset registry tags holding GetRegistryKey, ItemTags, ItemIcon and BuildPrototype, read by FItemManifest */
+    static const FName RegistryKeyTag;
+    static const FName ItemTagsTag;
+    static const FName ItemIconTag;
+    static const FName PrototypeTag;
+
     /** Core Functions */
     virtual FPrimaryAssetId GetPrimaryAssetId() const override;
     virtual FName GetRegistryKey() const;
+    virtual void PostRename(UObject* OldOuter, const FName OldName) override;
+    virtual void GetAssetRegistryTags(FAssetRegistryTagsContext Context) const override;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
     /** Creates a new instance of this item with runtime data */
     UFUNCTION(BlueprintCallable, Category = "Item")
     FItemStructure CreateItemInstance(int32 Quantity = 1) const;
 
-    /** Asset Loading */
+    /**
+     * Build a single-unit instance field by field. The registry caches the result per item
+     * and copies it for every new instance, prefer UItemRegistry::CreateItemInstance.
+     */
+    FItemStructure BuildPrototype() const;
+
+    /** Increases on every edit, so cached prototypes can tell they are stale */
+    FORCEINLINE uint32 GetDefinitionVersion() const { return DefinitionVersion; }
+
+    /** Soft path of one asset kind, null if the item has none */
+    FSoftObjectPath GetAssetPath(E_ItemAssetKind Kind) const;
+
+    /**
+     * Asset Loading, through UItemAssetCache. The assets stay resident until ReleaseItemAssets,
+     * callers that only need one kind should request it from the cache directly.
+     */
     UFUNCTION(BlueprintCallable, Category = "Item|Assets")
     void LoadItemAssets(const FOnItemAssetsLoadedDelegate& OnAssetsLoaded);
 
-protected:
-    /** Currently loaded assets */
-    UPROPERTY(Transient)
-    TArray<UObject*> LoadedAssets;
-
-    /** Stored callback for Blueprint asset loading */
-    FOnItemAssetsLoadedDelegate OnItemAssetsLoadedCallback;
+    /** Drop the handles taken by LoadItemAssets, the cache may evict the assets afterwards */
+    UFUNCTION(BlueprintCallable, Category = "Item|Assets")
+    void ReleaseItemAssets();
 
-    /** Called when assets are finished loading */
-    void OnItemAssetsLoaded();
+protected:
+    /** Handles keeping the assets requested by LoadItemAssets resident */
+    TArray<FItemAssetHandle> AssetHandles;
 
 public:
     /** Core Properties */
@@ -66,15 +95,19 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core", meta = (MultiLine = true))
     FText ItemDescription;
 
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core")
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core", AssetRegistrySearchable)
     E_ItemType ItemType;
 
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core")
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core", AssetRegistrySearchable)
     E_ItemCategory ItemCategory;
 
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core")
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core", AssetRegistrySearchable)
     E_ItemRarity ItemRarity;
 
+    /** Free-form classification for recipes, loot, vendors and UI filters, see UItemRegistry::QueryItemKeysByTags */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Core")
+    FGameplayTagContainer ItemTags;
+
     /** Stack Properties */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Stack")
     bool bIsStackable;
@@ -135,12 +168,21 @@ public:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Consumable")
     bool bIsConsumable;
 
+    /** Effects applied to the consumer, timed ones expire through UItemEffectSubsystem */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Consumable",
+        meta = (EditCondition = "bIsConsumable", EditConditionHides))
+    TArray<FItemEffectSpec> ConsumeEffects;
+
     /** Physical Properties */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Physical")
     E_WeightClass WeightClass;
 
+    /** Weight of a single unit, a stack weighs UnitWeight * quantity */
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Physical", AssetRegistrySearchable, meta = (ClampMin = "0.0"))
+    float UnitWeight;
+
     /** Economic Properties */
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Economic", meta = (ClampMin = "0"))
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Economic", AssetRegistrySearchable, meta = (ClampMin = "0"))
     int32 BaseValue;
 
     /** Special Properties */
@@ -153,4 +195,10 @@ public:
     /** Modifiers */
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Item|Modifiers")
     TArray<FItemModifier> DefaultModifiers;
+
+private:
+    /** GetRegistryKey result, built on first use and cleared on rename */
+    mutable FName CachedRegistryKey;
+
+    uint32 DefinitionVersion = 0;
 };
\ No newline at end of file
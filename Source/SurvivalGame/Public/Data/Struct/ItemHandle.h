@@ -0,0 +1,64 @@
+// ItemHandle.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ItemHandle.generated.h"
+
+/**
+ * @brief Compact identity of a registered item definition
+ *
+ * Assigned by UItemRegistry and resolved with a flat array index, so it is cheaper to
+ * store, compare and send than the FName registry key. Handles are only meaningful within
+ * the running registry, anything persisted alongside them must carry the registry's handle
+ * table so they can be remapped on load (see UItemRegistry::BuildHandleRemap).
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemHandle
+{
+    GENERATED_BODY()
+
+    /** 0 is the invalid handle */
+    UPROPERTY()
+    uint16 Value = 0;
+
+    FItemHandle() = default;
+    explicit FItemHandle(uint16 InValue) : Value(InValue) {}
+
+    FORCEINLINE bool IsValid() const { return Value != 0; }
+    FORCEINLINE int32 GetIndex() const { return Value; }
+    FORCEINLINE void Reset() { Value = 0; }
+
+    FORCEINLINE bool operator==(const FItemHandle& Other) const { return Value == Other.Value; }
+    FORCEINLINE bool operator!=(const FItemHandle& Other) const { return Value != Other.Value; }
+
+    friend FORCEINLINE uint32 GetTypeHash(const FItemHandle& Handle) { return Handle.Value; }
+
+    friend FArchive& operator<<(FArchive& Ar, FItemHandle& Handle)
+    {
+        return Ar << Handle.Value;
+    }
+
+    /** Packed on the wire, catalogs are small enough that most handles take one or two bytes */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+    {
+        uint32 WireValue = Value;
+        Ar.SerializeIntPacked(WireValue);
+        if (Ar.IsLoading())
+        {
+            Value = static_cast<uint16>(FMath::Min<uint32>(WireValue, MAX_uint16));
+        }
+        bOutSuccess = !Ar.IsError();
+        return true;
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemHandle> : public TStructOpsTypeTraitsBase2<FItemHandle>
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithIdenticalViaEquality = true,
+    };
+};
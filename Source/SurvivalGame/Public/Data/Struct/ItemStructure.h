@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "Engine/DataTable.h"
 #include "SurvivalGame/Public/Enums/ItemEnums.h"
+#include "SurvivalGame/Public/Data/Struct/ItemHandle.h"
 #include "ItemStructure.generated.h"
 
 class UItemInfo;
@@ -26,6 +27,42 @@ struct FItemModifier
     FItemModifier() : ModifierValue(0.0f) {}
 };
 
+/**
+ * @brief Effect applied when an item is consumed
+ */
+USTRUCT(BlueprintType)
+struct FItemEffectSpec
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    E_ItemEffect Effect;
+
+    /** Strength per stack, meaning depends on the effect */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    float Magnitude;
+
+    /** Seconds the effect lasts, 0 for instant effects such as restores */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect", meta = (ClampMin = "0.0", Units = "s"))
+    float Duration;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect")
+    E_EffectStackPolicy StackPolicy;
+
+    /** Upper bound on stacks for the Stack policy */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Effect", meta = (ClampMin = "1"))
+    int32 MaxStacks;
+
+    FItemEffectSpec()
+        : Effect(E_ItemEffect::None)
+        , Magnitude(0.0f)
+        , Duration(0.0f)
+        , StackPolicy(E_EffectStackPolicy::Refresh)
+        , MaxStacks(1)
+    {
+    }
+};
+
 /**
  * @brief Structure representing runtime item data
  */
@@ -38,6 +75,10 @@ struct SURVIVALGAME_API FItemStructure : public FTableRowBase
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Core")
     FName RegistryKey;
 
+    /** Registry-assigned handle of RegistryKey, filled in when the item is created or stored */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Core")
+    FItemHandle ItemHandle;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Core")
     TSoftObjectPtr<UItemInfo> ItemAsset;
 
@@ -96,6 +137,14 @@ struct SURVIVALGAME_API FItemStructure : public FTableRowBase
         meta = (EditCondition = "bHasDurability", ClampMin = "0.0"))
     float DurabilityDecayRate;
 
+    /**
+     * Decay clock time (server world seconds) at which CurrentDurability was last brought
+     * up to date, 0 until the item is first stored. Durability in between is derived in
+     * closed form, see GetDurabilityAt.
+     */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Durability")
+    double DecayTimestamp;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Durability")
     bool bIsDestroyable;
 
@@ -142,7 +191,7 @@ struct SURVIVALGAME_API FItemStructure : public FTableRowBase
         return RegistryKey.IsNone();
     }
 
-    /** Check if the item can be stacked with another item */
+    /** Check if the item can be stacked with another item, decay state is blended on merge (MergeDecay) */
     FORCEINLINE bool CanStack(const FItemStructure& Other) const
     {
         return bIsStackable && Other.bIsStackable && 
@@ -168,6 +217,57 @@ struct SURVIVALGAME_API FItemStructure : public FTableRowBase
         return bHasDurability && CurrentDurability <= 0;
     }
 
+    /** Whether durability drains over time at all */
+    FORCEINLINE bool CanDecay() const
+    {
+        return bHasDurability && DurabilityDecayRate > 0.0f && CurrentDurability > 0;
+    }
+
+    /** Whether durability is currently draining (decay clock started) */
+    FORCEINLINE bool IsDecaying() const
+    {
+        return CanDecay() && DecayTimestamp > 0.0;
+    }
+
+    /** Durability at the given decay clock time */
+    int32 GetDurabilityAt(double Time) const;
+
+    /** Decay clock time at which durability reaches zero, MAX_dbl if it never does */
+    double GetDecayExpiryTime() const;
+
+    /**
+     * Bring CurrentDurability up to the given time, switching to Broken or Spoiled at zero.
+     * The timestamp only advances by whole durability points, so repeated calls do not lose time.
+     * @return true if the item changed
+     */
+    bool ApplyDecay(double Time);
+
+    /**
+     * Fold Quantity items of Other into this stack's decay state, before the quantity is added.
+     * Both stacks are brought up to Time and the durability becomes their quantity-weighted
+     * average, so topping up old food with fresh food neither resets nor spoils the stack.
+     */
+    void MergeDecay(const FItemStructure& Other, int32 Quantity, double Time);
+
     /** Equality operator */
     bool operator==(const FItemStructure& Other) const;
+
+    /** Check if all per-instance state (key, quantity, state, durability, modifiers) matches */
+    bool IsIdenticalInstance(const FItemStructure& Other) const;
+
+    /**
+     * Compact wire format. Only the registry identity (the handle once the connection has
+     * verified it, the key otherwise) and per-instance state are sent, static definition
+     * data is rebuilt from the UItemRegistry on the receiving side.
+     */
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FItemStructure> : public TStructOpsTypeTraitsBase2<FItemStructure>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
 };
\ No newline at end of file
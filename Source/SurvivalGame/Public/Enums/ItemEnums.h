@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Misc/EnumRange.h"
 #include "ItemEnums.generated.h"
 
 /**
@@ -197,4 +198,33 @@ enum class E_SortMethod : uint8
     Rarity      UMETA(DisplayName = "Rarity"),
     Value       UMETA(DisplayName = "Value"),
     Weight      UMETA(DisplayName = "Weight")
-};
\ No newline at end of file
+};
+
+/**
+ * @brief How a timed item effect combines with an active effect of the same kind
+ */
+UENUM(BlueprintType)
+enum class E_EffectStackPolicy : uint8
+{
+    Refresh     UMETA(DisplayName = "Refresh Duration"),
+    Stack       UMETA(DisplayName = "Stack Magnitude"),
+    Extend      UMETA(DisplayName = "Extend Duration")
+};
+
+/**
+ * @brief Soft asset references of an item definition, loaded independently through UItemAssetCache
+ */
+UENUM(BlueprintType)
+enum class E_ItemAssetKind : uint8
+{
+    Icon            UMETA(DisplayName = "Icon"),
+    Mesh            UMETA(DisplayName = "Mesh"),
+    SkeletalMesh    UMETA(DisplayName = "Skeletal Mesh"),
+    Particle        UMETA(DisplayName = "Particle"),
+    PickupSound     UMETA(DisplayName = "Pickup Sound"),
+    UseSound        UMETA(DisplayName = "Use Sound"),
+    DropSound       UMETA(DisplayName = "Drop Sound"),
+
+    Count           UMETA(Hidden)
+};
+ENUM_RANGE_BY_COUNT(E_ItemAssetKind, E_ItemAssetKind::Count);
@@ -0,0 +1,152 @@
+// ContainerSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/SceneComponent.h"
+#include "UObject/ObjectKey.h"
+#include "Enums/ContainerType.h"
+#include "ContainerSubsystem.generated.h"
+
+class UItemContainerBase;
+class APawn;
+class AController;
+
+/**
+ * @brief Filter applied to container queries
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FContainerQueryFilter
+{
+    GENERATED_BODY()
+
+    /** Only containers of this type, None matches every type */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Query")
+    E_ContainerType ContainerType = E_ContainerType::None;
+
+    /** Only containers whose actor is owned by this actor (e.g. a player's placed chests) */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Query")
+    TObjectPtr<AActor> Owner = nullptr;
+
+    /** Skip containers hosted by this actor, usually the querying pawn */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Query")
+    TObjectPtr<AActor> IgnoreActor = nullptr;
+};
+
+/**
+ * @brief World-level registry of every item container
+ *
+ * Containers register on BeginPlay and leave on EndPlay. Each one gets an ID that is never
+ * reused within the world, and is kept in dense arrays per type and per owner so systems
+ * like autosave or audits iterate containers directly instead of walking actors. Owner
+ * buckets follow possession of pawn hosts, other hosts report owner changes.
+ *
+ * Containers are also bucketed in a uniform 2D grid by their actor's location. Radius
+ * queries only visit the cells they overlap and never touch the physics scene. Containers
+ * on movable actors follow their root component.
+ */
+UCLASS()
+class SURVIVALGAME_API UContainerSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Subsystem of the world the object lives in */
+    static UContainerSubsystem* Get(const UObject* WorldContextObject);
+
+    virtual void Deinitialize() override;
+
+    /** Registration, called by UItemContainerBase */
+    void RegisterContainer(UItemContainerBase* Container);
+    void UnregisterContainer(UItemContainerBase* Container);
+
+    /**
+     * Re-bucket a container whose actor changed owner. Pawns are followed through possession,
+     * hosts that call SetOwner after BeginPlay report it here (UItemContainerBase::NotifyOwnerChanged).
+     */
+    void UpdateContainerOwner(UItemContainerBase* Container);
+
+    /** Server: record that a container's contents changed since it was last consumed */
+    void MarkContainerDirty(UItemContainerBase* Container);
+
+    /** Server: take every container changed since the last call and mark them clean */
+    void ConsumeDirtyContainers(TArray<UItemContainerBase*>& OutContainers);
+
+    /** Lookup by the ID assigned at registration */
+    UFUNCTION(BlueprintPure, Category = "Containers")
+    UItemContainerBase* FindContainerById(int32 ContainerId) const;
+
+    /** Every registered container, in no particular order */
+    TConstArrayView<TObjectPtr<UItemContainerBase>> GetAllContainers() const { return DenseContainers; }
+
+    /** Registered containers of one type */
+    TConstArrayView<UItemContainerBase*> GetContainersOfType(E_ContainerType ContainerType) const;
+
+    /** Registered containers whose actor is owned by Owner, see UpdateContainerOwner */
+    TConstArrayView<UItemContainerBase*> GetContainersOwnedBy(const AActor* Owner) const;
+
+    UFUNCTION(BlueprintPure, Category = "Containers")
+    int32 GetNumContainers() const { return DenseContainers.Num(); }
+
+    /** Containers within Radius of Origin that pass the filter, closest first */
+    UFUNCTION(BlueprintCallable, Category = "Containers")
+    void FindContainersInRadius(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter, TArray<UItemContainerBase*>& OutContainers) const;
+
+    /** Closest container within Radius of Origin that passes the filter */
+    UFUNCTION(BlueprintPure, Category = "Containers")
+    UItemContainerBase* FindNearestContainer(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter) const;
+
+    /** Edge length of a grid cell, roughly the typical interaction range */
+    static constexpr float CellSize = 1000.0f;
+
+private:
+    struct FContainerEntry
+    {
+        TWeakObjectPtr<UItemContainerBase> Container;
+        int32 ContainerId = INDEX_NONE;
+        int32 DenseIndex = INDEX_NONE;
+        E_ContainerType ContainerType = E_ContainerType::None;
+        TObjectKey<AActor> OwnerKey;
+        TWeakObjectPtr<USceneComponent> TrackedRoot;
+        FDelegateHandle TransformHandle;
+        FVector Location = FVector::ZeroVector;
+        FIntPoint Cell = FIntPoint::ZeroValue;
+    };
+
+    static FIntPoint GetCell(const FVector& Location);
+    static bool PassesFilter(const UItemContainerBase& Container, const FContainerQueryFilter& Filter);
+    static TObjectKey<AActor> GetOwnerKey(const UItemContainerBase& Container);
+
+    void AddToCell(int32 EntryIndex);
+    void RemoveFromCell(int32 EntryIndex);
+    void RemoveFromOwnerBucket(const TObjectKey<AActor>& OwnerKey, UItemContainerBase* Container);
+    void HandleRootTransformUpdated(USceneComponent* Root, EUpdateTransformFlags UpdateFlags, ETeleportType Teleport, int32 EntryIndex);
+
+    UFUNCTION()
+    void HandlePawnControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+    /** Candidates within the radius with their squared distance, unsorted */
+    void GatherInRadius(const FVector& Origin, float Radius, const FContainerQueryFilter& Filter, TArray<TPair<float, UItemContainerBase*>>& OutHits) const;
+
+    /** Registered containers, indices stay valid until the container unregisters */
+    TSparseArray<FContainerEntry> Entries;
+    TMap<const UItemContainerBase*, int32> EntryLookup;
+    TMap<int32, int32> IdLookup;
+    int32 NextContainerId = 1;
+
+    /** Dense list of registered containers, swap-removed; DenseEntries holds the matching entry indices */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UItemContainerBase>> DenseContainers;
+    TArray<int32> DenseEntries;
+
+    /** Per-type and per-owner buckets, referenced through DenseContainers */
+    TArray<UItemContainerBase*> ContainersByType[static_cast<int32>(E_ContainerType::Hidden) + 1];
+    TMap<TObjectKey<AActor>, TArray<UItemContainerBase*>> ContainersByOwner;
+
+    /** IDs of containers changed since the last ConsumeDirtyContainers */
+    TArray<int32> DirtyContainerIds;
+
+    /** Grid cell to the entries whose actor is inside it */
+    TMap<FIntPoint, TArray<int32>> Cells;
+};
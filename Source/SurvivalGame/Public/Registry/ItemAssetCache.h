@@ -0,0 +1,167 @@
+// ItemAssetCache.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "Engine/StreamableManager.h"
+#include "Enums/ItemEnums.h"
+#include "ItemAssetCache.generated.h"
+
+class UItemInfo;
+class UItemAssetCache;
+
+/** Reference held by every copy of one FItemAssetHandle, released with the last copy */
+struct FItemAssetReference
+{
+    FItemAssetReference(UItemAssetCache* InCache, const FSoftObjectPath& InPath);
+    ~FItemAssetReference();
+
+    TWeakObjectPtr<UItemAssetCache> Cache;
+    FSoftObjectPath Path;
+};
+
+/**
+ * @brief Keeps one item asset resident while any copy of it exists
+ *
+ * Copies share the reference. Dropping the last copy before the asset finished loading
+ * cancels the load if nobody else wants it.
+ */
+USTRUCT(BlueprintType)
+struct SURVIVALGAME_API FItemAssetHandle
+{
+    GENERATED_BODY()
+
+    FItemAssetHandle() = default;
+
+    bool IsValid() const { return Reference.IsValid(); }
+    bool IsLoaded() const { return Get() != nullptr; }
+
+    /** The asset, nullptr until it has loaded */
+    UObject* Get() const;
+
+    template<typename T>
+    T* Get() const { return Cast<T>(Get()); }
+
+    const FSoftObjectPath& GetPath() const;
+
+    void Reset() { Reference.Reset(); }
+
+private:
+    friend class UItemAssetCache;
+
+    TSharedPtr<FItemAssetReference> Reference;
+};
+
+/**
+ * @brief Process-wide residency cache for the soft assets of item definitions
+ *
+ * Assets are requested one kind at a time (icon, mesh, sounds, ...) and shared by path,
+ * so two items using the same icon share one entry and concurrent requests for it wait on
+ * the same load. Requests are queued and started highest priority first with a bounded
+ * number in flight. Assets nobody holds a handle to stay resident until the configured
+ * memory budget is exceeded, then the least recently used ones are released first.
+ */
+UCLASS(Config = Game)
+class SURVIVALGAME_API UItemAssetCache : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /** Default request priority, UI prefetching should use a lower one */
+    static constexpr int32 DefaultPriority = 0;
+
+    static UItemAssetCache* Get();
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /**
+     * Request an asset. OnLoaded runs once the load finished (check IsLoaded on the handle,
+     * it may have failed), immediately if the asset is already resident, and never if every
+     * handle is dropped first.
+     * @return Handle keeping the asset resident, invalid if Path is null
+     */
+    FItemAssetHandle RequestAsset(const FSoftObjectPath& Path, int32 Priority = DefaultPriority, FSimpleDelegate OnLoaded = FSimpleDelegate());
+
+    /** RequestAsset for one soft reference of an item definition */
+    FItemAssetHandle RequestItemAsset(const UItemInfo* ItemInfo, E_ItemAssetKind Kind, int32 Priority = DefaultPriority, FSimpleDelegate OnLoaded = FSimpleDelegate());
+
+    /** Resident asset of a path, nullptr if it is not loaded through the cache */
+    UObject* FindAsset(const FSoftObjectPath& Path) const;
+
+    /** Release least recently used unreferenced assets until the budget is met */
+    void SetMemoryBudget(int64 InBudgetBytes);
+    int64 GetMemoryBudget() const { return BudgetBytes; }
+
+    /** Estimated size of everything resident, referenced or not */
+    int64 GetResidentBytes() const { return ResidentBytes; }
+
+    int32 GetNumEntries() const { return Entries.Num(); }
+    int32 GetNumPending() const { return PendingPaths.Num(); }
+
+protected:
+    /** Budget for resident assets, referenced ones are never evicted to meet it */
+    UPROPERTY(Config, EditDefaultsOnly, Category = "Item Assets", meta = (ClampMin = "0", Units = "MB"))
+    int32 MemoryBudgetMB = 256;
+
+    /** Requests handed to the streamer at once, the rest wait in priority order */
+    UPROPERTY(Config, EditDefaultsOnly, Category = "Item Assets", meta = (ClampMin = "1"))
+    int32 MaxConcurrentLoads = 16;
+
+private:
+    friend struct FItemAssetReference;
+
+    enum class EEntryState : uint8
+    {
+        Pending,
+        Loading,
+        Resident,
+
+        /** Kept while referenced so outstanding handles release the right entry */
+        Failed
+    };
+
+    struct FEntry
+    {
+        EEntryState State = EEntryState::Pending;
+        int32 RefCount = 0;
+
+        /** Highest priority requested while pending */
+        int32 Priority = MIN_int32;
+
+        /** Keeps the asset alive while resident */
+        TSharedPtr<FStreamableHandle> LoadHandle;
+        TWeakObjectPtr<UObject> Asset;
+        int64 SizeBytes = 0;
+
+        /** Waiters of all concurrent requests, run together once */
+        TArray<FSimpleDelegate> OnLoaded;
+
+        /** Position in the LRU list while resident and unreferenced */
+        TDoubleLinkedList<FSoftObjectPath>::TDoubleLinkedListNode* LruNode = nullptr;
+    };
+
+    void AddReference(const FSoftObjectPath& Path);
+    void Release(const FSoftObjectPath& Path);
+
+    void StartPendingLoads();
+    void HandleAssetLoaded(FSoftObjectPath Path);
+    void FailEntry(const FSoftObjectPath& Path);
+    void RemoveEntry(const FSoftObjectPath& Path);
+    void EnforceBudget();
+
+    static int64 EstimateSize(const UObject* Asset);
+
+    TMap<FSoftObjectPath, FEntry> Entries;
+
+    /** Requested but not handed to the streamer yet */
+    TArray<FSoftObjectPath> PendingPaths;
+    int32 NumLoading = 0;
+
+    /** Resident unreferenced entries, least recently released at the head */
+    TDoubleLinkedList<FSoftObjectPath> LruList;
+
+    int64 BudgetBytes = 0;
+    int64 ResidentBytes = 0;
+};
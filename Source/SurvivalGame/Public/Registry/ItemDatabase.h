@@ -0,0 +1,160 @@
+// ItemDatabase.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Data/Struct/ItemStructure.h"
+#include "Data/Struct/ItemHandle.h"
+#include "GameplayTagContainer.h"
+
+class UItemRegistry;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * On-disk layout of the cooked item database. Plain fixed-size records so the file can be
+ * used in place from a read-only mapping. All offsets are in bytes from the start of the
+ * file, strings are null-terminated UTF-8 in a shared string block.
+ */
+struct FItemDatabaseHeader
+{
+    uint32 Magic;
+    uint32 Version;
+    uint32 NumItems;
+    uint32 NumModifiers;
+    uint32 NumEffects;
+    uint32 NumTags;
+    uint32 StringBytes;
+    uint32 ItemsOffset;
+    uint32 ModifiersOffset;
+    uint32 EffectsOffset;
+    uint32 TagsOffset;
+    uint32 StringsOffset;
+};
+
+/** Gameplay fields of one item, record N holds the item with handle N + 1 */
+struct FItemDatabaseRecord
+{
+    enum EFlags : uint8
+    {
+        Stackable       = 1 << 0,
+        Equippable      = 1 << 1,
+        HasDurability   = 1 << 2,
+        Consumable      = 1 << 3,
+        QuestItem       = 1 << 4,
+        Unique          = 1 << 5
+    };
+
+    uint32 KeyOffset;
+    uint32 NameOffset;
+    int32 MaxStackSize;
+    int32 MaxDurability;
+    float DurabilityDecayRate;
+    float UnitWeight;
+    int32 BaseValue;
+    uint32 FirstModifier;
+    uint32 FirstEffect;
+    uint32 FirstTag;
+    uint16 NumModifiers;
+    uint16 NumEffects;
+    uint16 NumTags;
+    uint8 ItemType;
+    uint8 ItemCategory;
+    uint8 ItemRarity;
+    uint8 WeightClass;
+    uint8 ToolType;
+    uint8 WeaponType;
+    uint8 ArmorType;
+    uint8 Flags;
+    uint8 Padding[2];
+
+    FORCEINLINE bool HasFlag(EFlags Flag) const { return (Flags & Flag) != 0; }
+};
+
+struct FItemDatabaseModifier
+{
+    uint32 NameOffset;
+    float Value;
+};
+
+struct FItemDatabaseEffect
+{
+    float Magnitude;
+    float Duration;
+    int32 MaxStacks;
+    uint8 Effect;
+    uint8 StackPolicy;
+    uint8 Padding[2];
+};
+
+/** Gameplay tag name, an offset into the string block */
+struct FItemDatabaseTag
+{
+    uint32 NameOffset;
+};
+
+static_assert(sizeof(FItemDatabaseHeader) == 48, "Item database header layout changed, bump FItemDatabase::FormatVersion");
+static_assert(sizeof(FItemDatabaseRecord) == 56, "Item database record layout changed, bump FItemDatabase::FormatVersion");
+static_assert(sizeof(FItemDatabaseModifier) == 8, "Item database modifier layout changed, bump FItemDatabase::FormatVersion");
+static_assert(sizeof(FItemDatabaseEffect) == 16, "Item database effect layout changed, bump FItemDatabase::FormatVersion");
+static_assert(sizeof(FItemDatabaseTag) == 4, "Item database tag layout changed, bump FItemDatabase::FormatVersion");
+
+/**
+ * @brief Read-only, memory-mapped view of the cooked item database
+ *
+ * Written from a fully initialized UItemRegistry by UItemDatabaseCommandlet, in handle order,
+ * so handles read from it match the ones clients assign from their own definitions.
+ * Dedicated servers open it instead of loading every UItemInfo. The mapping is read-only
+ * and file-backed, so server processes on the same host share its pages.
+ */
+class SURVIVALGAME_API FItemDatabase
+{
+public:
+    static constexpr uint32 Magic = 0x44494753; // "SGID"
+    static constexpr uint32 FormatVersion = 3;
+
+    FItemDatabase();
+    ~FItemDatabase();
+
+    /** Where the commandlet writes the database and servers look for it */
+    static FString GetDefaultPath();
+
+    /** Serialize every item of an initialized registry, in handle order. Every definition must be loaded. */
+    static bool Write(const UItemRegistry& Registry, TArray<uint8>& OutBytes);
+
+    /** Map and validate a database file, nothing is copied */
+    bool Open(const FString& Path);
+    void Close();
+
+    bool IsOpen() const { return Header != nullptr; }
+    int32 Num() const { return Header ? static_cast<int32>(Header->NumItems) : 0; }
+
+    /** Record of a handle, nullptr if the handle is not in the database */
+    const FItemDatabaseRecord* FindRecord(FItemHandle Handle) const
+    {
+        return Handle.IsValid() && Handle.GetIndex() <= Num() ? &Records[Handle.GetIndex() - 1] : nullptr;
+    }
+
+    FName GetKey(const FItemDatabaseRecord& Record) const;
+    TConstArrayView<FItemDatabaseEffect> GetEffects(const FItemDatabaseRecord& Record) const;
+
+    /** Tags of a record, names unknown to this build are dropped */
+    FGameplayTagContainer GetTags(const FItemDatabaseRecord& Record) const;
+
+    /** Single-unit instance, equivalent to UItemInfo::BuildPrototype minus the asset references */
+    FItemStructure MakePrototype(const FItemDatabaseRecord& Record) const;
+
+private:
+    bool Validate(int64 FileSize) const;
+    const ANSICHAR* GetString(uint32 Offset) const;
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+
+    const FItemDatabaseHeader* Header = nullptr;
+    const FItemDatabaseRecord* Records = nullptr;
+    const FItemDatabaseModifier* Modifiers = nullptr;
+    const FItemDatabaseEffect* Effects = nullptr;
+    const FItemDatabaseTag* Tags = nullptr;
+    const ANSICHAR* Strings = nullptr;
+};
@@ -0,0 +1,27 @@
+// ItemDatabaseCommandlet.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ItemDatabaseCommandlet.generated.h"
+
+/**
+ * @brief Writes the item database dedicated servers map instead of loading every UItemInfo
+ *
+ * Also stages the FItemManifest cooked builds discover items from.
+ *
+ * Run after cooking, before staging:
+ *   UnrealEditor-Cmd SurvivalGame.uproject -run=ItemDatabase [-Output=<path>] [-Registry=<class path>]
+ * -Registry selects a UItemRegistry subclass when the game instance uses one.
+ */
+UCLASS()
+class SURVIVALGAME_API UItemDatabaseCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UItemDatabaseCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
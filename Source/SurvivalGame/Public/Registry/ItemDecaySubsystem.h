@@ -0,0 +1,45 @@
+// ItemDecaySubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemDecaySubsystem.generated.h"
+
+/**
+ * @brief Server-side driver for durability and spoilage decay
+ *
+ * Item durability is never ticked. Each item stores the time its durability was last
+ * brought up to date and is evaluated in closed form whenever it is read, persisted or
+ * replicated. This subsystem only runs a low-frequency sweep over a slice of the registered
+ * containers, so items reaching zero switch to Broken or Spoiled and fire their events.
+ */
+UCLASS()
+class SURVIVALGAME_API UItemDecaySubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * Current decay clock time for the world the object lives in. This is the server's
+     * world time, so item timestamps mean the same thing on every machine.
+     */
+    static double GetDecayTime(const UObject* WorldContextObject);
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    /** Seconds between sweeps */
+    static constexpr float SweepInterval = 1.0f;
+
+    /** Containers visited per sweep, the rest are picked up by the following sweeps */
+    static constexpr int32 ContainersPerSweep = 64;
+
+private:
+    void Sweep();
+
+    FTimerHandle SweepTimerHandle;
+
+    /** Position in the container registry's dense list where the next sweep starts */
+    int32 SweepCursor = 0;
+};
@@ -0,0 +1,100 @@
+// ItemEffectSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "Core/HierarchicalTimerWheel.h"
+#include "Data/Struct/ItemStructure.h"
+#include "ItemEffectSubsystem.generated.h"
+
+class UItemInfo;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnItemEffectApplied, AActor*, Target, E_ItemEffect, Effect, float, Magnitude, int32, Stacks);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnItemEffectExpired, AActor*, Target, E_ItemEffect, Effect);
+
+/**
+ * @brief Runtime for effects granted by consumed items
+ *
+ * Each target holds at most one active effect per E_ItemEffect, combined according to the
+ * spec's stack policy. Expiry is driven by a single hierarchical timer wheel, so applying,
+ * refreshing and cancelling are constant time, and every expiry of a frame is handled in one
+ * pass from Tick. Instant effects (zero duration) are broadcast and not tracked.
+ */
+UCLASS()
+class SURVIVALGAME_API UItemEffectSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UItemEffectSubsystem();
+
+    /** Subsystem of the world the object lives in */
+    static UItemEffectSubsystem* Get(const UObject* WorldContextObject);
+
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickable() const override;
+    virtual TStatId GetStatId() const override;
+
+    /** Apply every consume effect of an item definition */
+    UFUNCTION(BlueprintCallable, Category = "Item Effects")
+    void ApplyItemEffects(AActor* Target, const UItemInfo* ItemInfo);
+
+    /** Apply a list of effects, e.g. from UItemRegistry::GetConsumeEffects */
+    void ApplyEffects(AActor* Target, TConstArrayView<FItemEffectSpec> Specs);
+
+    UFUNCTION(BlueprintCallable, Category = "Item Effects")
+    void ApplyEffect(AActor* Target, const FItemEffectSpec& Spec);
+
+    /** End an effect early, without firing OnItemEffectExpired */
+    UFUNCTION(BlueprintCallable, Category = "Item Effects")
+    bool RemoveEffect(AActor* Target, E_ItemEffect Effect);
+
+    /** End every effect on a target, e.g. on death */
+    UFUNCTION(BlueprintCallable, Category = "Item Effects")
+    void RemoveAllEffects(AActor* Target);
+
+    /** Total magnitude (per-stack magnitude times stacks), 0 if the effect is not active */
+    UFUNCTION(BlueprintPure, Category = "Item Effects")
+    float GetEffectMagnitude(const AActor* Target, E_ItemEffect Effect) const;
+
+    UFUNCTION(BlueprintPure, Category = "Item Effects")
+    float GetEffectRemainingTime(const AActor* Target, E_ItemEffect Effect) const;
+
+    /** Events */
+    UPROPERTY(BlueprintAssignable, Category = "Item Effects|Events")
+    FOnItemEffectApplied OnItemEffectApplied;
+
+    UPROPERTY(BlueprintAssignable, Category = "Item Effects|Events")
+    FOnItemEffectExpired OnItemEffectExpired;
+
+    /** Expiry resolution */
+    static constexpr double WheelTickSeconds = 0.1;
+
+private:
+    struct FActiveEffect
+    {
+        TWeakObjectPtr<AActor> Target;
+        TObjectKey<AActor> TargetKey;
+        E_ItemEffect Effect = E_ItemEffect::None;
+        float Magnitude = 0.0f;
+        int32 Stacks = 1;
+        FWheelTimerId TimerId;
+    };
+
+    /** Keyed on TObjectKey so entries of destroyed targets can still be found and removed */
+    using FEffectKey = TPair<TObjectKey<AActor>, E_ItemEffect>;
+
+    void RemoveEffectAt(int32 EffectIndex);
+
+    /** Active effects, the wheel payload is the index in this array */
+    TSparseArray<FActiveEffect> ActiveEffects;
+    TMap<FEffectKey, int32> EffectLookup;
+
+    FHierarchicalTimerWheel Wheel;
+
+    /** Reused every frame to collect expired payloads */
+    TArray<uint64> ExpiredPayloads;
+};
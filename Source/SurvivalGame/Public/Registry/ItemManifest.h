@@ -0,0 +1,77 @@
+// ItemManifest.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "GameplayTagContainer.h"
+#include "Enums/ItemEnums.h"
+
+class UItemInfo;
+struct FAssetData;
+struct FItemStructure;
+
+/** What the registry knows about an item definition before its asset is loaded */
+struct SURVIVALGAME_API FItemManifestEntry
+{
+    FName RegistryKey;
+    FSoftObjectPath AssetPath;
+    E_ItemType ItemType = E_ItemType::None;
+    E_ItemCategory ItemCategory = E_ItemCategory::None;
+    E_ItemRarity ItemRarity = E_ItemRarity::None;
+    FGameplayTagContainer ItemTags;
+
+    /** Icon of the item, so inventory views can request it without the definition */
+    FSoftObjectPath IconPath;
+
+    /** Gameplay fields looked up per stack, so weights and values never need the definition */
+    float UnitWeight = 0.0f;
+    int32 BaseValue = 0;
+
+    /** UItemInfo::BuildPrototype as exported text, empty for database items. Parsed on first use. */
+    FString PrototypeText;
+
+    /** Read the asset registry tags of a UItemInfo, false if it was saved without them */
+    static bool FromAssetData(const FAssetData& AssetData, FItemManifestEntry& OutEntry);
+    static FItemManifestEntry FromItemInfo(const UItemInfo& ItemInfo);
+
+    /** Text form of a prototype, only the fields that differ from a default FItemStructure */
+    static FString ExportPrototype(const FItemStructure& Prototype);
+
+    /** Parse PrototypeText, false if there is none or it does not parse */
+    bool ImportPrototype(FItemStructure& OutPrototype) const;
+
+    friend FArchive& operator<<(FArchive& Ar, FItemManifestEntry& Entry);
+};
+
+/**
+ * @brief Every item definition in the project, read from asset registry tags
+ *
+ * Lets UItemRegistry know and bucket every item without loading a single UItemInfo.
+ * Written to disk so startup can skip gathering it: cooked builds read the copy
+ * UItemDatabaseCommandlet stages, editor builds keep the last result under Saved.
+ */
+struct SURVIVALGAME_API FItemManifest
+{
+    static constexpr uint32 Magic = 0x4D494753; // "SGIM"
+    static constexpr uint32 FormatVersion = 4;
+
+    /** Sorted by registry key */
+    TArray<FItemManifestEntry> Entries;
+
+    /** Staged next to the item database for cooked builds */
+    static FString GetStagedPath();
+
+    /** Last gathered manifest of an editor build */
+    static FString GetCachePath();
+
+    /**
+     * Collect every UItemInfo from the asset registry. With bScanPaths the item directories
+     * are scanned first, for callers that cannot rely on the asset registry being populated.
+     * Assets saved before the tags existed are loaded once to read their fields.
+     */
+    static FItemManifest Gather(bool bScanPaths);
+
+    bool Load(const FString& Path);
+    bool Save(const FString& Path) const;
+};
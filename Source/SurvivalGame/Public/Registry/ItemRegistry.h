@@ -5,12 +5,42 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Engine/DataTable.h"
+#include "Engine/StreamableManager.h"
 #include "Data/PrimaryData/ItemInfo.h"
 #include "Data/Struct/ItemStructure.h"
+#include "Data/Struct/ItemHandle.h"
+#include "Registry/ItemDatabase.h"
+#include "Registry/ItemManifest.h"
+#include "Registry/ItemTagIndex.h"
 #include "ItemRegistry.generated.h"
 
+class UPackageMap;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnItemRegistryInitialized);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnItemRegistered, FName, ItemKey);
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnItemInfoLoaded, UItemInfo*, ItemInfo);
+
+/**
+ * @brief Combined filter for UItemRegistry::QueryItems, None (or an empty query) leaves a field unfiltered
+ */
+USTRUCT(BlueprintType)
+struct FItemQueryFilter
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Registry")
+    E_ItemType ItemType = E_ItemType::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Registry")
+    E_ItemCategory ItemCategory = E_ItemCategory::None;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Registry")
+    E_ItemRarity ItemRarity = E_ItemRarity::None;
+
+    /** Matched against UItemInfo::ItemTags */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Registry")
+    FGameplayTagQuery TagQuery;
+};
 
 /**
  * @brief Manages the registration and retrieval of all items in the game
@@ -24,43 +54,255 @@ class SURVIVALGAME_API UItemRegistry : public UObject
 public:
     UItemRegistry();
 
-    /** Initialize the registry */
+    virtual void BeginDestroy() override;
+
+    /**
+     * Registry of the game instance a package map replicates for, used to rebuild item data
+     * in NetSerialize. Every game instance has its own, so several PIE instances in one
+     * process each resolve against theirs. nullptr outside of a net connection.
+     */
+    static UItemRegistry* GetForPackageMap(UPackageMap* Map);
+
+    /**
+     * Initialize the registry. Every item is discovered from its asset registry tags through
+     * FItemManifest, without loading it. Instances, weights, values and names come from the
+     * manifest, the UItemInfo itself is only loaded on request (LoadItemInfo, RequestItemInfos).
+     * DefaultItems the manifest does not cover are streamed in with one batched async request,
+     * OnItemRegistryInitialized fires once all of them are in.
+     *
+     * Dedicated servers first try the cooked FItemDatabase (skipped with -NoItemDatabase).
+     * When it is used no UItemInfo is loaded: instances, weights, values and consume effects
+     * come from the database, key queries and buckets are filled from its records, and the
+     * UItemInfo-returning lookups only see items registered at runtime.
+     */
     UFUNCTION(BlueprintCallable, Category = "Item Registry")
     void Initialize();
 
+    /** Whether every default item has been loaded and registered */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FORCEINLINE bool IsInitialized() const { return bIsInitialized; }
+
+    /** Block until the default items are loaded, for callers that cannot wait (commandlets, tests) */
+    void WaitUntilInitialized();
+
+    /** Run Callback now if the registry is ready, otherwise once it becomes ready */
+    void CallOrRegister_OnInitialized(FSimpleDelegate&& Callback);
+
     /** Register a new item */
     UFUNCTION(BlueprintCallable, Category = "Item Registry")
     bool RegisterItem(UItemInfo* ItemInfo);
 
-    /** Get item info by registry key */
+    /**
+     * Get item info by registry key. Never loads: nullptr until the definition is in memory,
+     * Blueprints that need it use LoadItemInfoAsync, names and icons are available without it.
+     */
     UFUNCTION(BlueprintPure, Category = "Item Registry")
     FORCEINLINE UItemInfo* GetItemInfo(const FName& RegistryKey) const
     {
-        return RegisteredItems.Contains(RegistryKey) ? RegisteredItems[RegistryKey] : nullptr;
+        UItemInfo* const* ItemInfo = RegisteredItems.Find(RegistryKey);
+        return ItemInfo ? *ItemInfo : nullptr;
+    }
+
+    /** Get item info by handle, a flat array index, nullptr until the definition is loaded */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FORCEINLINE UItemInfo* GetItemInfoByHandle(FItemHandle Handle) const
+    {
+        return ItemsByHandle.IsValidIndex(Handle.GetIndex()) ? ItemsByHandle[Handle.GetIndex()] : nullptr;
+    }
+
+    /** Whether the definition of a registered item is in memory */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FORCEINLINE bool IsItemInfoLoaded(const FName& RegistryKey) const { return RegisteredItems.Contains(RegistryKey); }
+
+    /** Definition of an item instance if it is loaded, through its handle when it has one */
+    FORCEINLINE UItemInfo* ResolveItemInfo(const FItemStructure& Item) const
+    {
+        return Item.ItemHandle.IsValid() ? GetItemInfoByHandle(Item.ItemHandle) : GetItemInfo(Item.RegistryKey);
     }
 
+    /**
+     * Load the definition of a known item, blocking until it is in memory. For gameplay code
+     * that cannot continue without it, everything else should use RequestItemInfos.
+     * @return nullptr if the item is unknown, has no asset or fails to load
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    UItemInfo* LoadItemInfo(FName RegistryKey);
+
+    /**
+     * Stream in the definition of one item for Blueprints, RequestItemInfos without a handle.
+     * OnLoaded receives the definition once it is registered (immediately if it already is),
+     * nullptr if the item is unknown or fails to load.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    void LoadItemInfoAsync(FName RegistryKey, const FOnItemInfoLoaded& OnLoaded);
+
+    /** Definitions of several items, the missing ones are loaded in one blocking batch instead of one by one */
+    void LoadItemInfos(TConstArrayView<FName> RegistryKeys, TArray<UItemInfo*>& OutItems);
+
+    /**
+     * Stream in the definitions of several items in one batch without blocking. OnLoaded runs
+     * once they are registered, immediately if all of them already are.
+     * @return Handle of the request, cancel or drop it to stop waiting. Invalid if nothing had to load.
+     */
+    TSharedPtr<FStreamableHandle> RequestItemInfos(TConstArrayView<FName> RegistryKeys, FSimpleDelegate OnLoaded,
+        TAsyncLoadPriority Priority = FStreamableManager::DefaultAsyncLoadPriority);
+
+    /** Handle of a registered item, invalid if unknown or handles are not assigned yet */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FItemHandle FindItemHandle(const FName& RegistryKey) const;
+
+    /** Registry key of a handle, NAME_None if the handle is not assigned */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FName GetItemKey(FItemHandle Handle) const;
+
     /** Create a new item instance */
     UFUNCTION(BlueprintCallable, Category = "Item Registry")
     FItemStructure CreateItemInstance(const FName& RegistryKey, int32 Quantity = 1) const;
 
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    FItemStructure CreateItemInstanceFromHandle(FItemHandle Handle, int32 Quantity = 1) const;
+
+    /**
+     * Append one instance per quantity to OutItems, for loot rolls and harvesting.
+     * Quantities above the stack size are split into full stacks, zero or negative ones are skipped.
+     * @return Number of instances appended
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    int32 CreateItemInstances(FItemHandle Handle, const TArray<int32>& Quantities, TArray<FItemStructure>& OutItems) const;
+
+    /** Cached single-unit instance of an item, new instances are copies of it. Never loads the definition. */
+    const FItemStructure* GetItemPrototype(FItemHandle Handle) const;
+
+    /**
+     * Registry key of every handle, indexed by handle value (index 0 is NAME_None).
+     * Persist this next to saved handles and pass it to BuildHandleRemap on load.
+     */
+    const TArray<FName>& GetHandleTable() const { return KeysByHandle; }
+
+    /** Size of the handle table, including the invalid handle */
+    int32 GetNumHandles() const { return KeysByHandle.Num(); }
+
+    /**
+     * Checksum of the registry keys of the first NumHandles handle table entries, in handle
+     * order. Handles are only appended, so two registries whose checksums agree for a count
+     * resolve every handle below it to the same item. 0 if fewer handles are assigned.
+     */
+    uint32 GetCatalogChecksum(int32 NumHandles) const;
+
+    /**
+     * Whether Handle may stand in for its registry key on the connection of a package map.
+     * Only true below the handle count both ends verified at login (see
+     * ASurvivalPlayerController), every other item is sent by key.
+     */
+    static bool IsHandleVerified(UPackageMap* Map, FItemHandle Handle);
+
+    /**
+     * Map handles saved against an older handle table to the current one. The result is
+     * indexed by saved handle value, items that no longer exist map to the invalid handle.
+     */
+    TArray<FItemHandle> BuildHandleRemap(TConstArrayView<FName> SavedHandleTable) const;
+
     /** Check if an item is registered */
     UFUNCTION(BlueprintPure, Category = "Item Registry")
     FORCEINLINE bool IsItemRegistered(const FName& RegistryKey) const
     {
-        return RegisteredItems.Contains(RegistryKey);
+        return KnownItems.Contains(RegistryKey);
     }
 
+    /** Whether definitions come from the cooked database instead of loaded UItemInfo assets */
+    FORCEINLINE bool IsUsingItemDatabase() const { return Database.IsOpen(); }
+
+    /** Get the weight of a single unit of an item, 0 if the item is unknown */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    float GetItemUnitWeight(const FName& RegistryKey) const;
+
+    /** Get the base value of a single unit of an item, 0 if the item is unknown */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    int32 GetItemBaseValue(const FName& RegistryKey) const;
+
+    /** Handle variants of the gameplay field lookups, valid with or without the database */
+    float GetUnitWeightByHandle(FItemHandle Handle) const;
+    int32 GetBaseValueByHandle(FItemHandle Handle) const;
+
+    /**
+     * Consume effects of an item. They are not part of the manifest, so without the database
+     * this loads the definition if it is not in memory yet.
+     * @return false if the item is unknown or not consumable
+     */
+    bool GetConsumeEffects(FItemHandle Handle, TArray<FItemEffectSpec>& OutEffects);
+
+    /** Display name of an item, from its definition or its manifest prototype, without loading anything */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    FText GetItemDisplayName(const FName& RegistryKey) const;
+
+    /** Icon of an item, from its definition or the manifest, without loading anything */
+    FSoftObjectPath GetItemIconPath(const FName& RegistryKey) const;
+
+    /**
+     * Position of an item when all known items are ordered by display name in the current
+     * culture, names come from GetItemDisplayName so nothing is loaded. Cached, and rebuilt
+     * after registrations or a culture change. Unknown items rank after every registered one.
+     */
+    UFUNCTION(BlueprintPure, Category = "Item Registry")
+    int32 GetItemNameSortRank(const FName& RegistryKey) const;
+
     /** Get all registered item keys */
     UFUNCTION(BlueprintPure, Category = "Item Registry")
     TArray<FName> GetAllRegisteredItemKeys() const;
 
-    /** Get all items of a specific type */
-    UFUNCTION(BlueprintPure, Category = "Item Registry")
-    TArray<UItemInfo*> GetItemsByType(E_ItemType ItemType) const;
+    /** Get all items of a specific type, loading their definitions */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    TArray<UItemInfo*> GetItemsByType(E_ItemType ItemType);
+
+    /** Get all items of a specific category, loading their definitions */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    TArray<UItemInfo*> GetItemsByCategory(E_ItemCategory ItemCategory);
+
+    /** Get all items of a specific rarity, loading their definitions */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    TArray<UItemInfo*> GetItemsByRarity(E_ItemRarity ItemRarity);
+
+    /**
+     * Append the key of every item matching all set fields of Filter to OutKeys, without
+     * loading anything. With a tag query the candidates come from the tag index, in handle
+     * order. Otherwise it walks the smallest matching bucket, in registration order.
+     * The remaining fields are checked per item.
+     * @return Number of keys appended
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    int32 QueryItemKeys(const FItemQueryFilter& Filter, TArray<FName>& OutKeys) const;
+
+    /**
+     * QueryItemKeys, then the definitions of the matches, loaded in one batch.
+     * @return Number of items appended
+     */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    int32 QueryItems(const FItemQueryFilter& Filter, TArray<UItemInfo*>& OutItems);
+
+    /**
+     * Every item whose ItemTags match Query, as one bit per handle value. Evaluated with
+     * bitset operations over the whole catalog, valid once the registry is initialized.
+     */
+    void QueryItemHandlesByTags(const FGameplayTagQuery& Query, TBitArray<>& OutMatches) const;
+
+    /** QueryItemKeys / QueryItems with only a tag query */
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    int32 QueryItemKeysByTags(const FGameplayTagQuery& Query, TArray<FName>& OutKeys) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Item Registry")
+    int32 QueryItemsByTags(const FGameplayTagQuery& Query, TArray<UItemInfo*>& OutItems);
 
-    /** Get all items of a specific category */
+    /** Whether an item carries Tag or one of its children, without loading its definition */
     UFUNCTION(BlueprintPure, Category = "Item Registry")
-    TArray<UItemInfo*> GetItemsByCategory(E_ItemCategory ItemCategory) const;
+    bool ItemHasTag(FItemHandle Handle, FGameplayTag Tag) const;
+
+    /** Non-allocating views of the precomputed buckets, in registration order */
+    TConstArrayView<FName> ViewItemKeysByType(E_ItemType ItemType) const { return ViewBucket(KeysByType, static_cast<uint8>(ItemType)); }
+    TConstArrayView<FName> ViewItemKeysByCategory(E_ItemCategory ItemCategory) const { return ViewBucket(KeysByCategory, static_cast<uint8>(ItemCategory)); }
+    TConstArrayView<FName> ViewItemKeysByRarity(E_ItemRarity ItemRarity) const { return ViewBucket(KeysByRarity, static_cast<uint8>(ItemRarity)); }
+
+    /** Manifest of every asset-backed item, what UItemDatabaseCommandlet stages for cooked builds */
+    FItemManifest BuildManifest() const;
 
     /** Events */
     UPROPERTY(BlueprintAssignable, Category = "Item Registry|Events")
@@ -70,21 +312,125 @@ public:
     FOnItemRegistered OnItemRegistered;
 
 protected:
-    /** Map of registered items */
+    /** Loaded definitions of registered items */
     UPROPERTY()
     TMap<FName, UItemInfo*> RegisteredItems;
 
-    /** Default items to register on initialization */
+    /**
+     * Items loaded and registered on initialization. Only needed for items outside the
+     * directories the asset manager scans, everything else is found through the manifest.
+     */
     UPROPERTY(EditDefaultsOnly, Category = "Item Registry")
     TArray<TSoftObjectPtr<UItemInfo>> DefaultItems;
 
+    /** Manifest discovery */
+    void DiscoverItems();
+    void HandleAssetRegistryFilesLoaded();
+    bool AddKnownItem(const FItemManifestEntry& Entry);
+
+    /** Register a definition LoadItemInfo or RequestItemInfos brought in, nullptr if it is not the item's */
+    UItemInfo* AddLoadedItemInfo(FName RegistryKey, UObject* LoadedObject);
+
     /** Load and register default items */
     void LoadDefaultItems();
+    void HandleDefaultItemsProgress(TSharedRef<FStreamableHandle> Handle);
+    void HandleDefaultItemsLoaded();
+    void RegisterLoadedDefaultItems(bool bFinal);
+    void FinishInitialization();
 
     /** Validate item info before registration */
     bool ValidateItemInfo(const UItemInfo* ItemInfo) const;
 
+    /** Cooked database, see Initialize */
+    bool ShouldUseItemDatabase() const;
+    bool InitializeFromDatabase();
+
+    /** Handle assignment */
+    void AssignHandle(FName RegistryKey);
+    void AssignPendingHandles();
+    void AppendCatalogChecksum(FName RegistryKey);
+
+    /** Secondary indices, filled as items register */
+    void AddToIndices(const FItemManifestEntry& Entry);
+    void ResetIndices();
+
+    static TConstArrayView<FName> ViewBucket(const TArray<TArray<FName>>& Buckets, uint8 Index)
+    {
+        return Buckets.IsValidIndex(Index) ? TConstArrayView<FName>(Buckets[Index]) : TConstArrayView<FName>();
+    }
+
+    /** Name collation cache */
+    void RebuildNameSortRanks() const;
+    void InvalidateNameSortRanks();
+
 private:
     /** Whether the registry has been initialized */
     bool bIsInitialized;
+
+    /** Default item load in flight */
+    bool bIsLoading = false;
+    TSharedPtr<FStreamableHandle> DefaultItemsHandle;
+
+    /** LoadItemInfoAsync requests in flight, Blueprint callers have no handle to keep them alive */
+    TArray<TSharedPtr<FStreamableHandle>> BlueprintItemRequests;
+    TArray<FSoftObjectPath> PendingDefaultItems;
+    int32 PendingDefaultItemsCursor = 0;
+    FSimpleMulticastDelegate OnInitializedNative;
+
+    /** Startup timings, in seconds */
+    double LoadStartTime = 0.0;
+    double DiscoveryTime = 0.0;
+    double LoadRequestTime = 0.0;
+    double RegisterTime = 0.0;
+
+    /** Every registered item, loaded or not, in registration order. Database items have no asset path */
+    TMap<FName, FItemManifestEntry> KnownItems;
+
+    /** Reconciles a cached manifest once the editor's asset registry scan finishes */
+    FDelegateHandle AssetRegistryFilesLoadedHandle;
+
+    /**
+     * Handle tables, index 0 is reserved for the invalid handle. Item slots stay null until
+     * the definition is first loaded. Items known at startup get their
+     * handles in registry key order once loading completes, so every process with the same
+     * catalog agrees on them regardless of the order packages finished streaming in.
+     * Items registered after initialization are appended. The database numbers its records
+     * the same way, but nothing forces two builds to match, so connections only send handles
+     * once the catalogs were compared (see GetCatalogChecksum).
+     */
+    TArray<UItemInfo*> ItemsByHandle;
+    TArray<FName> KeysByHandle;
+    TMap<FName, FItemHandle> HandlesByKey;
+
+    /** Running checksum of KeysByHandle, entry N covers handles 1 to N */
+    TArray<uint32> CatalogChecksums;
+
+    /**
+     * Prototype instance per handle. Built from the manifest (or the database) while the
+     * definition is not loaded, then from the definition, and again when its version moves on.
+     */
+    struct FItemPrototype
+    {
+        FItemStructure Item;
+        uint32 DefinitionVersion = 0;
+        bool bIsBuilt = false;
+        bool bFromDefinition = false;
+    };
+    mutable TArray<FItemPrototype> PrototypesByHandle;
+
+    /** Mapped database, open only on servers that initialized from it */
+    FItemDatabase Database;
+
+    /** ItemTags of every handle, inverted */
+    FItemTagIndex TagIndex;
+
+    /** Registry keys bucketed by enum value */
+    TArray<TArray<FName>> KeysByType;
+    TArray<TArray<FName>> KeysByCategory;
+    TArray<TArray<FName>> KeysByRarity;
+
+    /** Registry key to name rank, built on first use */
+    mutable TMap<FName, int32> NameSortRanks;
+    mutable bool bNameSortRanksValid = false;
+    FDelegateHandle CultureChangedHandle;
 };
\ No newline at end of file
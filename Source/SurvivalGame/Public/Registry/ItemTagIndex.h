@@ -0,0 +1,46 @@
+// ItemTagIndex.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Containers/BitArray.h"
+
+/**
+ * @brief Inverted index from gameplay tag to the items carrying it, one bit per item
+ *
+ * Items are identified by a dense index (the registry uses handle values), so evaluating
+ * a FGameplayTagQuery is a handful of word-wise AND/OR/NOT passes over the catalog
+ * instead of a tag container match per definition. Parent tags are indexed too, so
+ * hierarchical matches behave exactly like FGameplayTagContainer::HasTag.
+ */
+class SURVIVALGAME_API FItemTagIndex
+{
+public:
+    void Reset();
+
+    /** Index the tags of the item at ItemIndex */
+    void Add(int32 ItemIndex, const FGameplayTagContainer& Tags);
+
+    /**
+     * Set bit N of OutMatches for every item N in [0, NumItems) whose tags match Query.
+     * An empty query matches nothing, as with FGameplayTagQuery::Matches.
+     */
+    void Evaluate(const FGameplayTagQuery& Query, int32 NumItems, TBitArray<>& OutMatches) const;
+
+    /** Items carrying Tag or one of its children */
+    const TBitArray<>* FindItems(const FGameplayTag& Tag) const { return ItemsByTag.Find(Tag); }
+
+    int32 NumTags() const { return ItemsByExactTag.Num(); }
+
+private:
+    void EvaluateExpr(const FGameplayTagQueryExpression& Expr, int32 NumItems, TBitArray<>& OutMatches) const;
+    void MatchAnyTag(TConstArrayView<FGameplayTag> Tags, bool bExact, int32 NumItems, TBitArray<>& OutMatches) const;
+    void MatchAllTags(TConstArrayView<FGameplayTag> Tags, bool bExact, int32 NumItems, TBitArray<>& OutMatches) const;
+
+    /** Explicit tags and all of their parents */
+    TMap<FGameplayTag, TBitArray<>> ItemsByTag;
+
+    /** Explicit tags only, for the exact-match query types */
+    TMap<FGameplayTag, TBitArray<>> ItemsByExactTag;
+};
@@ -7,6 +7,7 @@
 
 class UWidgetSwitcher;
 class UInventoryWidget;
+class UItemContainerBase;
 
 UENUM(BlueprintType)
 enum class EInventoryLayoutTab : uint8
@@ -47,6 +48,10 @@ protected:
     UFUNCTION(BlueprintCallable, Category = "UI|Navigation")
     void SwitchToTab(EInventoryLayoutTab NewTab);
 
+    /** Show a container in the inventory tab, its first pages of icons are requested right away */
+    UFUNCTION(BlueprintCallable, Category = "UI|Inventory")
+    void OpenContainer(UItemContainerBase* Container);
+
     /** Get currently active tab */
     UFUNCTION(BlueprintPure, Category = "UI|State")
     EInventoryLayoutTab GetActiveTab() const { return ActiveTab; }
@@ -4,17 +4,123 @@
 
 #include "CoreMinimal.h"
 #include "CommonUserWidget.h"
+#include "Data/Struct/ItemStructure.h"
+#include "Registry/ItemAssetCache.h"
 #include "InventoryWidget.generated.h"
 
+class UItemContainerBase;
+class UTexture2D;
+struct FStreamableHandle;
+
 /**
- * 
+ * @brief Slot view of one item container (Blueprint: W_InventoryWidget)
+ *
+ * Item icons are soft references, so instead of each slot loading its own the widget
+ * requests them through UItemAssetCache in one pass whenever the container opens, scrolls
+ * or changes: the visible slots first, then PrefetchPages pages past them at a lower
+ * priority. Requests for slots that left that range are dropped, which cancels the ones
+ * that had not loaded yet. Icon paths come from the item manifest, so no definition is
+ * loaded for them. The hovered item's mesh is requested ahead for previews, after
+ * streaming in its definition if needed.
  */
 UCLASS()
 class SURVIVALGAME_API UInventoryWidget : public UCommonUserWidget
 {
-	GENERATED_BODY()
+    GENERATED_BODY()
+
+public:
+    UInventoryWidget(const FObjectInitializer& ObjectInitializer);
+
+    /** Show a container, nullptr clears the view */
+    UFUNCTION(BlueprintCallable, Category = "Inventory|UI")
+    void SetContainer(UItemContainerBase* InContainer);
+
+    UFUNCTION(BlueprintPure, Category = "Inventory|UI")
+    UItemContainerBase* GetContainer() const { return Container.Get(); }
+
+    /** Called by the slot view whenever it scrolls or is resized */
+    UFUNCTION(BlueprintCallable, Category = "Inventory|UI")
+    void SetVisibleSlots(int32 FirstSlot, int32 NumSlots);
+
+    /** Called when the cursor enters a slot, INDEX_NONE when it leaves */
+    UFUNCTION(BlueprintCallable, Category = "Inventory|UI")
+    void SetHoveredSlot(int32 SlotIndex);
+
+    /** Icon of a slot if it is in memory. Otherwise nullptr, and OnSlotIconLoaded follows once it is */
+    UFUNCTION(BlueprintPure, Category = "Inventory|UI")
+    UTexture2D* GetSlotIcon(int32 SlotIndex) const;
+
+    /** Preview mesh of the hovered slot, static or skeletal, nullptr until it is loaded */
+    UFUNCTION(BlueprintPure, Category = "Inventory|UI")
+    UObject* GetHoveredItemMesh() const { return HoveredMeshHandle.Get(); }
+
+    /** Request the icons of the current range, keeps the requests still in it */
+    void RefreshPrefetch();
+
+    /** Drop every request, icons that loaded stay in the cache until it evicts them */
+    void CancelPrefetch();
+
+protected:
+    virtual void NativeDestruct() override;
+
+    /** An icon requested for the current range finished loading */
+    UFUNCTION(BlueprintImplementableEvent, Category = "Inventory|UI")
+    void OnSlotIconLoaded(int32 SlotIndex, UTexture2D* Icon);
+
+    UFUNCTION(BlueprintImplementableEvent, Category = "Inventory|UI")
+    void OnHoveredMeshLoaded(int32 SlotIndex, UObject* Mesh);
+
+    /** Slots assumed visible until the view reports its range */
+    UPROPERTY(EditAnywhere, Category = "Inventory|Prefetch", meta = (ClampMin = "1"))
+    int32 DefaultVisibleSlots;
+
+    /** Pages past the visible slots whose icons are requested ahead */
+    UPROPERTY(EditAnywhere, Category = "Inventory|Prefetch", meta = (ClampMin = "0"))
+    int32 PrefetchPages;
+
+private:
+    /** One icon and the slots in range showing it */
+    struct FIconRequest
+    {
+        FItemAssetHandle Handle;
+        TArray<int32, TInlineAllocator<4>> Slots;
+    };
+
+    UFUNCTION()
+    void HandleContainerUpdated(const TArray<FItemStructure>& Items);
+
+    UFUNCTION()
+    void HandleSlotsChanged(const TArray<int32>& SlotIndices);
+
+    void HandleIconLoaded(FSoftObjectPath Path);
+    void HandleHoveredMeshLoaded(FSoftObjectPath Path);
+
+    /** Request the preview mesh of HoveredSlot */
+    void RequestHoveredMesh();
+    void CancelHoveredItemInfoRequest();
+
+    /** Item in a slot, nullptr for empty or invalid slots */
+    const FItemStructure* GetSlotItem(int32 SlotIndex) const;
+
+    int32 GetNumVisibleSlots() const { return NumVisibleSlots > 0 ? NumVisibleSlots : DefaultVisibleSlots; }
+    int32 GetPrefetchEnd() const { return FirstVisibleSlot + GetNumVisibleSlots() * (1 + PrefetchPages); }
+
+    TWeakObjectPtr<UItemContainerBase> Container;
+
+    int32 FirstVisibleSlot = 0;
+    int32 NumVisibleSlots = 0;
+    int32 HoveredSlot = INDEX_NONE;
 
+    /** Container size the requests were made for, slot changes are reported separately */
+    int32 NumContainerSlots = 0;
 
+    /** Icon requests of the current range, by icon so slots sharing one share the request */
+    TMap<FSoftObjectPath, FIconRequest> IconRequests;
 
+    FSoftObjectPath HoveredMeshPath;
+    FItemAssetHandle HoveredMeshHandle;
 
+    /** Definition of the hovered item being streamed in, its mesh paths are not in the manifest */
+    FName HoveredItemInfoKey;
+    TSharedPtr<FStreamableHandle> HoveredItemInfoRequest;
 };